@@ -0,0 +1,31 @@
+#Generates a translation unit holding every file in SHADER_DIR as constexpr string data
+#Usage: cmake -DSHADER_DIR=<dir> -DOUTPUT=<file.cpp> -P embed_shaders.cmake
+
+file(GLOB SHADER_FILES "${SHADER_DIR}/*")
+#sorted so EmbeddedShaders::find can binary search by name
+list(SORT SHADER_FILES)
+
+set(CONTENT "// Generated by cmake/embed_shaders.cmake from ${SHADER_DIR}, do not edit\n")
+string(APPEND CONTENT "#include \"embedded_shaders.h\"\n\n")
+string(APPEND CONTENT "namespace {\n    constexpr EmbeddedShader SHADERS[] = {\n")
+
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME "${SHADER_FILE}" NAME)
+    file(READ "${SHADER_FILE}" SHADER_SOURCE)
+    string(FIND "${SHADER_SOURCE}" ")__shader__" DELIM_POS)
+    if(NOT DELIM_POS EQUAL -1)
+        message(FATAL_ERROR "${SHADER_FILE} contains the raw string delimiter )__shader__")
+    endif()
+    string(APPEND CONTENT "        {\"${SHADER_NAME}\", R\"__shader__(${SHADER_SOURCE})__shader__\"},\n")
+endforeach()
+
+string(APPEND CONTENT "    };\n}\n\n")
+string(APPEND CONTENT "std::span<const EmbeddedShader> EmbeddedShaders::all() {\n    return SHADERS;\n}\n")
+
+#only touch the output when something changed so we dont trigger needless rebuilds
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_CONTENT)
+endif()
+if(NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+    file(WRITE "${OUTPUT}" "${CONTENT}")
+endif()
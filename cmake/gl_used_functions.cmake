@@ -0,0 +1,44 @@
+#Scans the sources for GL calls and writes an X-macro list of the ones glad knows about,
+#so GLLoader can skip resolving the hundreds of entry points we never touch
+#Usage: cmake -DSOURCE_DIR=<dir> -DGLAD_HEADER=<glad.h> -DOUTPUT=<file.h> -P gl_used_functions.cmake
+
+file(READ "${GLAD_HEADER}" GLAD_CONTENT)
+string(REGEX MATCHALL "#define gl[A-Za-z0-9_]+ glad_gl" GLAD_DEFINES "${GLAD_CONTENT}")
+set(GLAD_FUNCTIONS "")
+foreach(GLAD_DEFINE ${GLAD_DEFINES})
+    string(REGEX REPLACE "#define (gl[A-Za-z0-9_]+) glad_gl" "\\1" GLAD_FUNCTION "${GLAD_DEFINE}")
+    list(APPEND GLAD_FUNCTIONS ${GLAD_FUNCTION})
+endforeach()
+
+file(GLOB_RECURSE SOURCE_FILES "${SOURCE_DIR}/*.cpp" "${SOURCE_DIR}/*.h")
+set(USED_FUNCTIONS "")
+foreach(SOURCE_FILE ${SOURCE_FILES})
+    file(READ "${SOURCE_FILE}" SOURCE_CONTENT)
+    string(REGEX MATCHALL "gl[A-Z][A-Za-z0-9_]*" SOURCE_MATCHES "${SOURCE_CONTENT}")
+    list(APPEND USED_FUNCTIONS ${SOURCE_MATCHES})
+endforeach()
+
+#the loader itself always needs these
+list(APPEND USED_FUNCTIONS glGetString glGetStringi glGetIntegerv)
+list(REMOVE_DUPLICATES USED_FUNCTIONS)
+list(SORT USED_FUNCTIONS)
+
+set(CONTENT "// Generated by cmake/gl_used_functions.cmake from ${SOURCE_DIR}, do not edit\n")
+string(APPEND CONTENT "#ifndef GL_USED_FUNCTIONS_H\n#define GL_USED_FUNCTIONS_H\n\n")
+string(APPEND CONTENT "//names are without the gl prefix so glads #define glFoo glad_glFoo cant expand them\n")
+string(APPEND CONTENT "#define GL_USED_FUNCTIONS(X)")
+foreach(USED_FUNCTION ${USED_FUNCTIONS})
+    list(FIND GLAD_FUNCTIONS ${USED_FUNCTION} FOUND)
+    if(NOT FOUND EQUAL -1)
+        string(SUBSTRING ${USED_FUNCTION} 2 -1 SHORT_NAME)
+        string(APPEND CONTENT " \\\n    X(${SHORT_NAME})")
+    endif()
+endforeach()
+string(APPEND CONTENT "\n\n#endif\n")
+
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_CONTENT)
+endif()
+if(NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+    file(WRITE "${OUTPUT}" "${CONTENT}")
+endif()
@@ -0,0 +1,90 @@
+#include "action_map.h"
+
+extern "C" {
+#include <GLFW/glfw3.h>
+}
+
+void ActionMap::bind(Action action, InputEvent::Type type, int32_t code) {
+    this->bindings.push_back(Binding{type, code, action});
+    if (this->states.size() <= action) {
+        this->states.resize(action + 1, State{0, 0, 0, 0});
+    }
+}
+
+void ActionMap::beginTick() {
+    for (auto &state : this->states) {
+        state.presses = 0;
+        state.releases = 0;
+    }
+}
+
+void ActionMap::apply(const InputEvent &event) {
+    //repeats dont change anything
+    if (event.action != GLFW_PRESS && event.action != GLFW_RELEASE) {
+        return;
+    }
+
+    for (const auto &binding : this->bindings) {
+        if (binding.type != event.type || binding.code != event.code) {
+            continue;
+        }
+
+        auto &state = this->states[binding.action];
+        if (event.action == GLFW_PRESS) {
+            state.heldBindings++;
+            state.presses++;
+        } else if (state.heldBindings > 0) {
+            //a release without a press happens when the key was already down before the window got focus
+            state.heldBindings--;
+            state.releases++;
+        }
+        state.lastEventTime = event.time;
+    }
+}
+
+void ActionMap::apply(std::span<const InputEvent> events) {
+    for (const auto &event : events) {
+        this->apply(event);
+    }
+}
+
+bool ActionMap::isDown(Action action) const {
+    return action < this->states.size() && this->states[action].heldBindings > 0;
+}
+
+uint32_t ActionMap::getPressCount(Action action) const {
+    return action < this->states.size() ? this->states[action].presses : 0;
+}
+
+uint32_t ActionMap::getReleaseCount(Action action) const {
+    return action < this->states.size() ? this->states[action].releases : 0;
+}
+
+double ActionMap::getLastEventTime(Action action) const {
+    return action < this->states.size() ? this->states[action].lastEventTime : 0;
+}
+
+bool ActionMap::isBound(const InputEvent &event) const {
+    for (const auto &binding : this->bindings) {
+        if (binding.type == event.type && binding.code == event.code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ActionMap::countPresses(Action action, std::span<const InputEvent> events) const {
+    uint32_t presses = 0;
+    for (const auto &event : events) {
+        if (event.action != GLFW_PRESS) {
+            continue;
+        }
+        for (const auto &binding : this->bindings) {
+            if (binding.action == action && binding.type == event.type && binding.code == event.code) {
+                presses++;
+                break;
+            }
+        }
+    }
+    return presses;
+}
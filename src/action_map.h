@@ -0,0 +1,54 @@
+#ifndef ACTION_MAP_H
+#define ACTION_MAP_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "input_event.h"
+
+/** 
+ * Maps key/mouse button events onto game actions and tracks action state purely from events, 
+ * so it ends up the same live and in a replay. Actions are small ints, an enum on the users side
+ * */
+class ActionMap {
+    public:
+        using Action = uint32_t;
+
+        //an action can have several bindings, its down while any of them is
+        void bind(Action action, InputEvent::Type type, int32_t code);
+
+        //clears the per tick press/release counts, call before applying a ticks events
+        void beginTick();
+        void apply(const InputEvent &event);
+        void apply(std::span<const InputEvent> events);
+
+        bool isDown(Action action) const;
+        //presses during this tick, counts presses that were released again before the tick ran
+        uint32_t getPressCount(Action action) const;
+        uint32_t getReleaseCount(Action action) const;
+        //timestamp of the last event that changed the action
+        double getLastEventTime(Action action) const;
+
+        bool isBound(const InputEvent &event) const;
+        //presses of action in events without applying them, to predict what the next tick will do
+        uint32_t countPresses(Action action, std::span<const InputEvent> events) const;
+
+    private:
+        struct Binding {
+            InputEvent::Type type;
+            int32_t code;
+            Action action;
+        };
+
+        struct State {
+            uint32_t heldBindings;
+            uint32_t presses;
+            uint32_t releases;
+            double lastEventTime;
+        };
+
+        std::vector<Binding> bindings;
+        std::vector<State> states;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "allocation_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <execinfo.h>
+#include <unistd.h>
+
+#ifdef GLTEMPLATE_COUNT_ALLOCATIONS
+namespace {
+    struct Offender {
+        std::size_t size;
+        int depth;
+        void *frames[AllocationCounter::MAX_STACK_DEPTH];
+    };
+
+    std::atomic<uint64_t> allocationCount = 0;
+    std::atomic<uint64_t> allocationBytes = 0;
+
+    std::atomic<bool> armed = false;
+    std::atomic<uint64_t> armedCount = 0;
+    Offender offenders[AllocationCounter::MAX_OFFENDERS];
+    //backtrace can allocate itself, dont record those
+    thread_local bool recording = false;
+
+    void recordOffender(std::size_t size) {
+        recording = true;
+        uint64_t slot = armedCount.fetch_add(1, std::memory_order_relaxed);
+        if (slot < AllocationCounter::MAX_OFFENDERS) {
+            offenders[slot].size = size;
+            offenders[slot].depth = backtrace(offenders[slot].frames, AllocationCounter::MAX_STACK_DEPTH);
+        }
+        recording = false;
+    }
+
+    void writeString(const char *text) {
+        std::size_t length = 0;
+        while (text[length]) {
+            length++;
+        }
+        ssize_t ignored = write(STDERR_FILENO, text, length);
+        (void)ignored;
+    }
+
+    void writeNumber(uint64_t value) {
+        char digits[21];
+        int i = sizeof(digits) - 1;
+        digits[i] = '\0';
+        do {
+            digits[--i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        writeString(digits + i);
+    }
+
+    void* countedAlloc(std::size_t size, std::size_t alignment) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+        if (armed.load(std::memory_order_relaxed) && !recording) {
+            recordOffender(size);
+        }
+
+        void *p = alignment > alignof(std::max_align_t) 
+            ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+            : std::malloc(size == 0 ? 1 : size);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+}
+
+void* operator new(std::size_t size) {
+    return countedAlloc(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+    return countedAlloc(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationCounter::getCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::getBytes() {
+    return allocationBytes.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::arm() {
+    //first backtrace call loads libgcc, get that out of the way before counting
+    void *frames[1];
+    backtrace(frames, 1);
+
+    armedCount.store(0, std::memory_order_relaxed);
+    armed.store(true, std::memory_order_seq_cst);
+}
+
+void AllocationCounter::disarm() {
+    armed.store(false, std::memory_order_seq_cst);
+}
+
+uint64_t AllocationCounter::getArmedCount() {
+    return armedCount.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::printOffenders() {
+    uint64_t count = std::min<uint64_t>(getArmedCount(), MAX_OFFENDERS);
+    for (uint64_t i = 0; i < count; i++) {
+        writeString("allocation of ");
+        writeNumber(offenders[i].size);
+        writeString(" bytes at:\n");
+        backtrace_symbols_fd(offenders[i].frames, offenders[i].depth, STDERR_FILENO);
+    }
+    if (getArmedCount() > count) {
+        writeNumber(getArmedCount() - count);
+        writeString(" more not recorded\n");
+    }
+}
+#else
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationCounter::getCount() {
+    return 0;
+}
+
+uint64_t AllocationCounter::getBytes() {
+    return 0;
+}
+
+void AllocationCounter::arm() {
+}
+
+void AllocationCounter::disarm() {
+}
+
+uint64_t AllocationCounter::getArmedCount() {
+    return 0;
+}
+
+void AllocationCounter::printOffenders() {
+}
+#endif
@@ -0,0 +1,28 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+/** 
+ * Counts calls to the global operator new. Only does anything in builds with GLTEMPLATE_COUNT_ALLOCATIONS, 
+ * where this replaces the global operator new/delete, otherwise the counts stay 0.
+ * While armed, every allocation (on any thread) counts as an offender and the first few get their call stack recorded
+ * */
+class AllocationCounter {
+    public:
+        static constexpr int MAX_OFFENDERS = 8;
+        static constexpr int MAX_STACK_DEPTH = 32;
+
+        static bool isEnabled();
+        static uint64_t getCount();
+        static uint64_t getBytes();
+
+        //clears the previous offenders
+        static void arm();
+        static void disarm();
+        static uint64_t getArmedCount();
+        //writes the recorded call stacks to stderr, without allocating. Build with -rdynamic to get names
+        static void printOffenders();
+};
+
+#endif
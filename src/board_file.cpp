@@ -0,0 +1,197 @@
+#include "board_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    void writeAll(int fd, const void *data, size_t size, const std::string &path) {
+        auto bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format("Failed to write {}: {}", path, std::strerror(errno)));
+            }
+            bytes += written, size -= written;
+        }
+    }
+}
+
+void BoardFile::save(const std::filesystem::path &path, const GameBoardPos &size, std::span<const BoardCell> cells) {
+    uint64_t cellCount = static_cast<uint64_t>(size.x) * size.y * size.z;
+    if (cells.size() != cellCount) {
+        throw std::runtime_error(std::format("Board has {} cells, expected {}", cells.size(), cellCount));
+    }
+
+    auto data = reinterpret_cast<const std::byte*>(cells.data());
+    uint64_t dataBytes = cells.size_bytes();
+    uint64_t chunkCount = (dataBytes + CHUNK_BYTES - 1) / CHUNK_BYTES;
+
+    Header header{};
+    header.magic = MAGIC, header.version = VERSION;
+    header.sizeX = size.x, header.sizeY = size.y, header.sizeZ = size.z;
+    header.cellSize = sizeof(BoardCell);
+    header.chunkBytes = CHUNK_BYTES;
+    header.chunkCount = chunkCount;
+    header.checksumOffset = alignToPage(sizeof(Header));
+    header.dataOffset = alignToPage(header.checksumOffset + chunkCount * sizeof(uint64_t));
+    header.dataBytes = dataBytes;
+
+    std::vector<uint64_t> checksums(chunkCount);
+    for (uint64_t chunk = 0; chunk < chunkCount; chunk++) {
+        uint64_t offset = chunk * CHUNK_BYTES;
+        checksums[chunk] = checksum(data + offset, std::min<uint64_t>(CHUNK_BYTES, dataBytes - offset));
+    }
+
+    std::string tmpPath = path.string() + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("File: {} failed to open: {}", tmpPath, std::strerror(errno)));
+    }
+
+    try {
+        std::vector<std::byte> padding(header.dataOffset, std::byte{0});
+        std::memcpy(padding.data(), &header, sizeof(header));
+        std::memcpy(padding.data() + header.checksumOffset, checksums.data(), checksums.size() * sizeof(uint64_t));
+        writeAll(fd, padding.data(), padding.size(), tmpPath);
+        writeAll(fd, data, dataBytes, tmpPath);
+
+        if (fsync(fd) != 0) {
+            throw std::runtime_error(std::format("Failed to sync {}: {}", tmpPath, std::strerror(errno)));
+        }
+    } catch (...) {
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw;
+    }
+    close(fd);
+
+    std::filesystem::rename(tmpPath, path);
+}
+
+BoardFile::BoardFile(const std::filesystem::path &path) : 
+    mapping(nullptr), mappingSize(0), size{}
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("File: {} failed to open: {}", path.string(), std::strerror(errno)));
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error(std::format("File: {} is not a board file", path.string()));
+    }
+    this->mappingSize = info.st_size;
+
+    //private + writable means edits are copy on write and never reach the file
+    void *ptr = mmap(nullptr, this->mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error(std::format("Failed to map {}: {}", path.string(), std::strerror(errno)));
+    }
+    this->mapping = static_cast<std::byte*>(ptr);
+
+    Header header;
+    std::memcpy(&header, this->mapping, sizeof(header));
+    uint64_t cellCount = static_cast<uint64_t>(header.sizeX) * header.sizeY * header.sizeZ;
+
+    std::string error;
+    if (header.magic != MAGIC) {
+        error = "bad magic";
+    } else if (header.version != VERSION) {
+        error = std::format("unsupported version {}", header.version);
+    } else if (header.cellSize != sizeof(BoardCell) || header.chunkBytes != CHUNK_BYTES) {
+        error = "layout mismatch";
+    } else if (header.sizeX < 0 || header.sizeY < 0 || header.sizeZ < 0 || header.dataBytes != cellCount * sizeof(BoardCell) ||
+            header.chunkCount != (header.dataBytes + CHUNK_BYTES - 1) / CHUNK_BYTES) {
+        error = "bad dimensions";
+    } else if (header.checksumOffset + header.chunkCount * sizeof(uint64_t) > header.dataOffset || 
+            header.dataOffset % PAGE_SIZE != 0 || header.dataOffset + header.dataBytes > this->mappingSize) {
+        error = "truncated";
+    }
+
+    if (!error.empty()) {
+        munmap(this->mapping, this->mappingSize);
+        throw std::runtime_error(std::format("Board file {} is invalid: {}", path.string(), error));
+    }
+
+    this->size = {header.sizeX, header.sizeY, header.sizeZ};
+    this->cells = {reinterpret_cast<BoardCell*>(this->mapping + header.dataOffset), static_cast<size_t>(cellCount)};
+    this->checksums = {reinterpret_cast<const uint64_t*>(this->mapping + header.checksumOffset), static_cast<size_t>(header.chunkCount)};
+    this->verified.assign(header.chunkCount, false);
+}
+
+BoardFile::~BoardFile() {
+    munmap(this->mapping, this->mappingSize);
+}
+
+const GameBoardPos& BoardFile::getSize() const {
+    return this->size;
+}
+
+std::span<BoardCell> BoardFile::getCells() {
+    return this->cells;
+}
+
+void BoardFile::ensureVerified(uint64_t cellIndex) {
+    uint64_t chunk = cellIndex * sizeof(BoardCell) / CHUNK_BYTES;
+    if (!this->verified[chunk]) {
+        this->verifyChunk(chunk);
+    }
+}
+
+void BoardFile::verifyAll() {
+    for (uint64_t chunk = 0; chunk < this->verified.size(); chunk++) {
+        if (!this->verified[chunk]) {
+            this->verifyChunk(chunk);
+        }
+    }
+}
+
+void BoardFile::verifyChunk(uint64_t chunk) {
+    auto data = reinterpret_cast<const std::byte*>(this->cells.data());
+    uint64_t offset = chunk * CHUNK_BYTES;
+    uint64_t bytes = std::min<uint64_t>(CHUNK_BYTES, this->cells.size_bytes() - offset);
+
+    if (checksum(data + offset, bytes) != this->checksums[chunk]) {
+        throw std::runtime_error(std::format("Board file chunk {} is corrupt", chunk));
+    }
+    this->verified[chunk] = true;
+}
+
+uint64_t BoardFile::checksum(const std::byte *data, size_t size) {
+    //four independent lanes of multiply/xorshift over 64 bit words, fast enough to not matter next to the page faults
+    constexpr uint64_t PRIME = 0x9e3779b97f4a7c15ull;
+    uint64_t lanes[4] = {PRIME, PRIME ^ 1, PRIME ^ 2, PRIME ^ 3};
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            std::memcpy(&word, data + i + lane * 8, 8);
+            lanes[lane] = (lanes[lane] ^ word) * PRIME;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    uint64_t hash = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7) ^ size;
+    for (; i < size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * PRIME;
+    }
+    return hash ^ (hash >> 31);
+}
+
+uint64_t BoardFile::alignToPage(uint64_t offset) {
+    return (offset + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
@@ -0,0 +1,72 @@
+#ifndef BOARD_FILE_H
+#define BOARD_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include "gameboard_utils.h"
+
+struct BoardCell {
+    uint8_t r, g, b;
+    uint8_t state;
+};
+
+/** 
+ * Fixed layout board save file:
+ *   Header (padded to a page) | uint64 checksum per chunk (padded to a page) | cells, x fastest then y then z
+ * The file is mmaped copy on write, so opening is O(1) and edits never touch the file.
+ * Chunks get checksummed the first time something reads them.
+ * */
+class BoardFile {
+    public:
+        static constexpr uint32_t MAGIC = 0x42544c47;      //"GLTB"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint64_t PAGE_SIZE = 4096;
+        static constexpr uint64_t CHUNK_BYTES = 1 << 20;
+
+        //writes to a temp file, fsyncs and renames over path, throws on failure
+        static void save(const std::filesystem::path &path, const GameBoardPos &size, std::span<const BoardCell> cells);
+
+        BoardFile(const std::filesystem::path &path);
+        ~BoardFile();
+
+        BoardFile(const BoardFile&) = delete;
+        BoardFile& operator=(const BoardFile&) = delete;
+
+        const GameBoardPos& getSize() const;
+        //unchecked, use ensureVerified for anything read from the file
+        std::span<BoardCell> getCells();
+
+        //checks the chunk holding cellIndex against its checksum once, throws if it doesnt match
+        void ensureVerified(uint64_t cellIndex);
+        void verifyAll();
+
+        static uint64_t checksum(const std::byte *data, size_t size);
+
+    private:
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            int32_t sizeX, sizeY, sizeZ;
+            uint32_t cellSize;
+            uint64_t chunkBytes;
+            uint64_t chunkCount;
+            uint64_t checksumOffset;
+            uint64_t dataOffset;
+            uint64_t dataBytes;
+        };
+
+        std::byte *mapping;
+        size_t mappingSize;
+        GameBoardPos size;
+        std::span<BoardCell> cells;
+        std::span<const uint64_t> checksums;
+        std::vector<bool> verified;
+
+        static uint64_t alignToPage(uint64_t offset);
+        void verifyChunk(uint64_t chunk);
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "buffer_age.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <dlfcn.h>
+
+namespace {
+    //the bits of egl.h / glx.h we need, so building doesnt depend on either set of headers
+    constexpr int32_t EGL_EXTENSIONS = 0x3055;
+    constexpr int32_t EGL_DRAW = 0x3059;
+    constexpr int32_t EGL_BUFFER_AGE_EXT = 0x313D;
+    constexpr int GLX_SCREEN = 0x800C;
+    constexpr int GLX_BACK_BUFFER_AGE_EXT = 0x20F4;
+
+    struct EglFunctions {
+        void* (*getCurrentDisplay)();
+        void* (*getCurrentSurface)(int32_t readDraw);
+        const char* (*queryString)(void *display, int32_t name);
+        unsigned int (*querySurface)(void *display, void *surface, int32_t attribute, int32_t *value);
+    } egl;
+
+    struct GlxFunctions {
+        void* (*getCurrentDisplay)();
+        unsigned long (*getCurrentDrawable)();
+        void* (*getCurrentContext)();
+        int (*queryContext)(void *display, void *context, int attribute, int *value);
+        const char* (*queryExtensionsString)(void *display, int screen);
+        void (*queryDrawable)(void *display, unsigned long drawable, int attribute, unsigned int *value);
+    } glx;
+
+    //only libraries that are already loaded, if glfw didnt pick that api theres nothing to ask
+    void* findLoaded(const char *const *names) {
+        for (const char *const *name = names; *name; name++) {
+            if (void *library = dlopen(*name, RTLD_LAZY | RTLD_NOLOAD)) {
+                return library;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    bool lookup(void *library, T &func, const char *name) {
+        func = reinterpret_cast<T>(dlsym(library, name));
+        return func != nullptr;
+    }
+
+    //extension strings are space separated, a plain strstr would match prefixes of longer names
+    bool hasExtension(const char *extensions, const char *name) {
+        size_t length = std::strlen(name);
+        for (const char *at = extensions; at && (at = std::strstr(at, name)); at += length) {
+            bool start = at == extensions || at[-1] == ' ';
+            bool end = at[length] == ' ' || at[length] == '\0';
+            if (start && end) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+BufferAge::Api BufferAge::api = BufferAge::Api::Unchecked;
+
+bool BufferAge::isSupported() {
+    if (api == Api::Unchecked) {
+        detect();
+    }
+    return api != Api::None;
+}
+
+int BufferAge::query() {
+    if (!isSupported()) {
+        return 0;
+    }
+
+    if (api == Api::Egl) {
+        int32_t age = 0;
+        void *display = egl.getCurrentDisplay();
+        if (!egl.querySurface(display, egl.getCurrentSurface(EGL_DRAW), EGL_BUFFER_AGE_EXT, &age)) {
+            return 0;
+        }
+        return age;
+    }
+
+    unsigned int age = 0;
+    glx.queryDrawable(glx.getCurrentDisplay(), glx.getCurrentDrawable(), GLX_BACK_BUFFER_AGE_EXT, &age);
+    return static_cast<int>(age);
+}
+
+void BufferAge::detect() {
+    api = Api::None;
+
+    static const char *const eglNames[] = {"libEGL.so.1", "libEGL.so", nullptr};
+    if (void *library = findLoaded(eglNames)) {
+        bool loaded = lookup(library, egl.getCurrentDisplay, "eglGetCurrentDisplay") && 
+                lookup(library, egl.getCurrentSurface, "eglGetCurrentSurface") && 
+                lookup(library, egl.queryString, "eglQueryString") && 
+                lookup(library, egl.querySurface, "eglQuerySurface");
+        //EGL can be loaded without being the api of the current context, then theres no current display
+        void *display = loaded ? egl.getCurrentDisplay() : nullptr;
+        if (display && hasExtension(egl.queryString(display, EGL_EXTENSIONS), "EGL_EXT_buffer_age")) {
+            api = Api::Egl;
+            return;
+        }
+    }
+
+    static const char *const glxNames[] = {"libGLX.so.0", "libGL.so.1", "libGL.so", nullptr};
+    if (void *library = findLoaded(glxNames)) {
+        bool loaded = lookup(library, glx.getCurrentDisplay, "glXGetCurrentDisplay") && 
+                lookup(library, glx.getCurrentDrawable, "glXGetCurrentDrawable") && 
+                lookup(library, glx.getCurrentContext, "glXGetCurrentContext") && 
+                lookup(library, glx.queryContext, "glXQueryContext") && 
+                lookup(library, glx.queryExtensionsString, "glXQueryExtensionsString") && 
+                lookup(library, glx.queryDrawable, "glXQueryDrawable");
+        void *display = loaded ? glx.getCurrentDisplay() : nullptr;
+        int screen = 0;
+        if (display && glx.queryContext(display, glx.getCurrentContext(), GLX_SCREEN, &screen) == 0 && 
+                hasExtension(glx.queryExtensionsString(display, screen), "GLX_EXT_buffer_age")) {
+            api = Api::Glx;
+        }
+    }
+}
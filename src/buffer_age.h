@@ -0,0 +1,29 @@
+#ifndef BUFFER_AGE_H
+#define BUFFER_AGE_H
+
+/** 
+ * Back buffer age of the current context's surface through EGL_EXT_buffer_age (wayland, and x11 on EGL) or 
+ * GLX_EXT_buffer_age (x11 on GLX). Looks the entry points up in whichever of libEGL / libGLX glfw already loaded, 
+ * so nothing extra gets linked. Main thread only
+ * */
+class BufferAge {
+    public:
+        //needs a current context, checked once. Without it the back buffer is undefined after every swap
+        static bool isSupported();
+
+        //frames since the back buffer was last drawn, 0 if unknown. Call right before drawing
+        static int query();
+
+    private:
+        enum class Api {
+            Unchecked,
+            None,
+            Egl,
+            Glx
+        };
+
+        static Api api;
+        static void detect();
+};
+
+#endif
@@ -0,0 +1,314 @@
+#include "checkpointer.h"
+#include "rle.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    void writeAll(int fd, const void *data, size_t size) {
+        auto bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format("write failed: {}", std::strerror(errno)));
+            }
+            bytes += written, size -= written;
+        }
+    }
+}
+
+Checkpointer::Checkpointer() : 
+    chunkStatesCapacity(0), active(false), board(nullptr), chunkCount(0), tick(0), status(Status::Idle), chunksDone(0), 
+    jobQueued(false), stopping(false), captureMs(0), writeMs(0)
+{
+    this->worker = std::thread(&Checkpointer::run, this);
+}
+
+Checkpointer::~Checkpointer() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->cv.notify_all();
+    this->worker.join();
+
+    //every queued job detaches when it finishes, this only matters if one never got to
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->board) {
+        this->board->detachCheckpointer(this);
+        this->board = nullptr;
+    }
+}
+
+bool Checkpointer::begin(GameBoard &board, std::span<const std::byte> entities, uint64_t tick, const std::filesystem::path &path) {
+    auto start = std::chrono::steady_clock::now();
+    if (this->status == Status::Running) {
+        return false;
+    }
+
+    auto cells = board.getCells();
+    this->board = &board;
+    this->boardBytes = {reinterpret_cast<const std::byte*>(cells.data()), cells.size_bytes()};
+    this->chunkCount = (this->boardBytes.size() + CHUNK_BYTES - 1) / CHUNK_BYTES;
+    this->tick = tick;
+    this->path = path;
+
+    //entities are small, a plain copy is the snapshot
+    this->entityBuffer.assign(entities.begin(), entities.end());
+
+    if (this->chunkStatesCapacity < this->chunkCount) {
+        this->chunkStates = std::make_unique<std::atomic<uint8_t>[]>(this->chunkCount);
+        this->chunkStatesCapacity = this->chunkCount;
+    }
+    for (uint64_t chunk = 0; chunk < this->chunkCount; chunk++) {
+        this->chunkStates[chunk].store(Pending, std::memory_order_relaxed);
+    }
+    if (this->chunkCopies.size() < this->chunkCount) {
+        this->chunkCopies.resize(this->chunkCount);
+    }
+
+    this->chunksDone = 0;
+    this->status = Status::Running;
+    this->active.store(true, std::memory_order_release);
+    board.attachCheckpointer(this);
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobQueued = true;
+        this->captureMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    this->cv.notify_all();
+    return true;
+}
+
+void Checkpointer::wait() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv.wait(lock, [this]() {
+        return !this->jobQueued && this->status != Status::Running;
+    });
+}
+
+Checkpointer::Status Checkpointer::getStatus() const {
+    return this->status;
+}
+
+float Checkpointer::getProgress() const {
+    if (this->chunkCount == 0) {
+        return this->status == Status::Running ? 0.0f : 1.0f;
+    }
+    return static_cast<float>(this->chunksDone) / this->chunkCount;
+}
+
+std::string Checkpointer::getError() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->error;
+}
+
+double Checkpointer::getLastCaptureMs() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->captureMs;
+}
+
+double Checkpointer::getLastWriteMs() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->writeMs;
+}
+
+void Checkpointer::beforeWrite(uint64_t cellIndex) {
+    if (!this->active.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    uint64_t chunk = cellIndex * sizeof(BoardCell) / CHUNK_BYTES;
+    auto &state = this->chunkStates[chunk];
+
+    uint8_t expected = Pending;
+    if (state.compare_exchange_strong(expected, Copying, std::memory_order_acquire)) {
+        auto bytes = this->chunkBytes(chunk);
+        this->chunkCopies[chunk].assign(bytes.begin(), bytes.end());
+        state.store(Copied, std::memory_order_release);
+        return;
+    }
+
+    //the writer is compressing this chunk from live memory right now, at most one chunk worth of wait
+    while (state.load(std::memory_order_acquire) == Reading) {
+        std::this_thread::yield();
+    }
+}
+
+std::span<const std::byte> Checkpointer::chunkBytes(uint64_t chunk) const {
+    uint64_t offset = chunk * CHUNK_BYTES;
+    return this->boardBytes.subspan(offset, std::min<uint64_t>(CHUNK_BYTES, this->boardBytes.size() - offset));
+}
+
+void Checkpointer::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->cv.wait(lock, [this]() {
+                return this->jobQueued || this->stopping;
+            });
+            //finish a queued checkpoint even when stopping, the board is only guaranteed consistent through us
+            if (!this->jobQueued) {
+                return;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Status result = Status::Succeeded;
+        std::string jobError;
+        try {
+            this->writeCheckpoint();
+        } catch (const std::exception &e) {
+            result = Status::Failed;
+            jobError = e.what();
+        }
+
+        //stop copy on write before anyone can start the next one, and let go of the board, it only has to outlive the job
+        this->active.store(false, std::memory_order_release);
+        this->board->detachCheckpointer(this);
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->board = nullptr;
+            this->jobQueued = false;
+            this->error = std::move(jobError);
+            this->writeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            this->status = result;
+        }
+        this->cv.notify_all();
+    }
+}
+
+void Checkpointer::writeCheckpoint() {
+    std::string tmpPath = this->path.string() + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        //the chunks still have to be marked done or writers would keep copying
+        for (uint64_t chunk = 0; chunk < this->chunkCount; chunk++) {
+            this->chunkStates[chunk].store(Done, std::memory_order_release);
+        }
+        throw std::runtime_error(std::format("File: {} failed to open: {}", tmpPath, std::strerror(errno)));
+    }
+
+    std::vector<std::byte> compressed;
+    try {
+        auto size = this->board->getSize();
+        Header header{
+            MAGIC, VERSION, this->tick, size.x, size.y, size.z, 
+            sizeof(BoardCell), CHUNK_BYTES, this->chunkCount, this->entityBuffer.size()
+        };
+        writeAll(fd, &header, sizeof(header));
+
+        Rle::compress(this->entityBuffer, compressed);
+        uint64_t entityCompressed = compressed.size();
+        writeAll(fd, &entityCompressed, sizeof(entityCompressed));
+        writeAll(fd, compressed.data(), compressed.size());
+
+        for (uint64_t chunk = 0; chunk < this->chunkCount; chunk++) {
+            auto &state = this->chunkStates[chunk];
+
+            uint8_t expected = Pending;
+            bool live = state.compare_exchange_strong(expected, Reading, std::memory_order_acquire);
+            if (!live) {
+                //game thread got there first, wait for its copy to land
+                while (state.load(std::memory_order_acquire) != Copied) {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::span<const std::byte> bytes = live ? this->chunkBytes(chunk) : std::span<const std::byte>(this->chunkCopies[chunk]);
+            compressed.clear();
+            Rle::compress(bytes, compressed);
+            ChunkRecord record{
+                static_cast<uint32_t>(bytes.size()), 
+                static_cast<uint32_t>(compressed.size()), 
+                BoardFile::checksum(bytes.data(), bytes.size())
+            };
+            state.store(Done, std::memory_order_release);
+
+            writeAll(fd, &record, sizeof(record));
+            writeAll(fd, compressed.data(), compressed.size());
+            this->chunksDone++;
+        }
+
+        if (fsync(fd) != 0) {
+            throw std::runtime_error(std::format("Failed to sync {}: {}", tmpPath, std::strerror(errno)));
+        }
+    } catch (...) {
+        for (uint64_t chunk = 0; chunk < this->chunkCount; chunk++) {
+            this->chunkStates[chunk].store(Done, std::memory_order_release);
+        }
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw;
+    }
+    close(fd);
+
+    std::filesystem::rename(tmpPath, this->path);
+}
+
+Checkpointer::Snapshot Checkpointer::load(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("File: {} failed to open", path.string()));
+    }
+
+    auto fail = [&path](const std::string &why) {
+        return std::runtime_error(std::format("Checkpoint {} is invalid: {}", path.string(), why));
+    };
+
+    Header header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != MAGIC || header.version != VERSION || header.cellSize != sizeof(BoardCell)) {
+        throw fail("bad header");
+    }
+
+    Snapshot snapshot;
+    snapshot.tick = header.tick;
+    snapshot.size = {header.sizeX, header.sizeY, header.sizeZ};
+    snapshot.cells.resize(static_cast<uint64_t>(header.sizeX) * header.sizeY * header.sizeZ);
+
+    std::vector<std::byte> compressed;
+    uint64_t entityCompressed = 0;
+    file.read(reinterpret_cast<char*>(&entityCompressed), sizeof(entityCompressed));
+    compressed.resize(entityCompressed);
+    file.read(reinterpret_cast<char*>(compressed.data()), compressed.size());
+    snapshot.entities.resize(header.entityBytes);
+    if (!file || !Rle::decompressInto(compressed, snapshot.entities)) {
+        throw fail("bad entity data");
+    }
+
+    auto cellBytes = std::as_writable_bytes(std::span<BoardCell>(snapshot.cells));
+    uint64_t offset = 0;
+    for (uint64_t chunk = 0; chunk < header.chunkCount; chunk++) {
+        ChunkRecord record{};
+        file.read(reinterpret_cast<char*>(&record), sizeof(record));
+        if (!file || offset + record.rawBytes > cellBytes.size()) {
+            throw fail(std::format("bad chunk {}", chunk));
+        }
+
+        compressed.resize(record.compressedBytes);
+        file.read(reinterpret_cast<char*>(compressed.data()), compressed.size());
+        auto out = cellBytes.subspan(offset, record.rawBytes);
+        if (!file || !Rle::decompressInto(compressed, out) || BoardFile::checksum(out.data(), out.size()) != record.checksum) {
+            throw fail(std::format("chunk {} is corrupt", chunk));
+        }
+        offset += record.rawBytes;
+    }
+
+    if (offset != cellBytes.size()) {
+        throw fail("truncated");
+    }
+    return snapshot;
+}
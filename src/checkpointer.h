@@ -0,0 +1,121 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "board_file.h"
+#include "game_board.h"
+
+/** 
+ * Writes board + entity snapshots on a background thread. begin() only memcpys the (small) entity blob and resets
+ * per chunk state, the board itself is copy on write: GameBoard::set copies a chunk aside the first time its written 
+ * while the checkpoint hasnt saved it yet. Chunks are RLE compressed, then the file is fsynced and renamed into place.
+ * */
+class Checkpointer {
+    public:
+        enum class Status {
+            Idle,
+            Running,
+            Succeeded,
+            Failed
+        };
+
+        struct Snapshot {
+            uint64_t tick;
+            GameBoardPos size;
+            std::vector<BoardCell> cells;
+            std::vector<std::byte> entities;
+        };
+
+        Checkpointer();
+        ~Checkpointer();
+
+        Checkpointer(const Checkpointer&) = delete;
+        Checkpointer& operator=(const Checkpointer&) = delete;
+
+        /** 
+         * Call at a tick boundary. Returns false (and does nothing) if the previous checkpoint is still running.
+         * board has to stay alive until the checkpoint finishes (its detached again then), and writes to it must go through GameBoard::set
+         * */
+        bool begin(GameBoard &board, std::span<const std::byte> entities, uint64_t tick, const std::filesystem::path &path);
+        void wait();
+
+        Status getStatus() const;
+        float getProgress() const;
+        std::string getError() const;
+        double getLastCaptureMs() const;        //time begin() took, i.e. the frame hitch
+        double getLastWriteMs() const;
+
+        static Snapshot load(const std::filesystem::path &path);
+
+        //GameBoard calls this before writing a cell
+        void beforeWrite(uint64_t cellIndex);
+
+    private:
+        static constexpr uint32_t MAGIC = 0x43544c47;      //"GLTC"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint64_t CHUNK_BYTES = 64 * 1024;
+
+        enum ChunkState : uint8_t {
+            Pending,        //not saved yet, live memory still matches the snapshot
+            Reading,        //writer thread is compressing it straight from live memory
+            Copying,        //game thread is copying it aside before a write
+            Copied,
+            Done
+        };
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t tick;
+            int32_t sizeX, sizeY, sizeZ;
+            uint32_t cellSize;
+            uint64_t chunkBytes;
+            uint64_t chunkCount;
+            uint64_t entityBytes;
+        };
+
+        struct ChunkRecord {
+            uint32_t rawBytes;
+            uint32_t compressedBytes;
+            uint64_t checksum;
+        };
+
+        //pooled between checkpoints so begin() doesnt allocate in steady state
+        std::vector<std::byte> entityBuffer;
+        std::vector<std::vector<std::byte>> chunkCopies;
+        std::unique_ptr<std::atomic<uint8_t>[]> chunkStates;
+        size_t chunkStatesCapacity;
+
+        std::atomic<bool> active;
+        GameBoard *board;
+        std::span<const std::byte> boardBytes;
+        uint64_t chunkCount;
+        uint64_t tick;
+        std::filesystem::path path;
+
+        std::atomic<Status> status;
+        std::atomic<uint64_t> chunksDone;
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        bool jobQueued, stopping;
+        std::string error;
+        double captureMs, writeMs;
+
+        std::thread worker;
+
+        void run();
+        void writeCheckpoint();
+        std::span<const std::byte> chunkBytes(uint64_t chunk) const;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef DAMAGE_RECT_H
+#define DAMAGE_RECT_H
+
+//rect in GL screenspace coords (-1 to 1)
+struct DamageRect {
+    float minX, minY;
+    float maxX, maxY;
+
+    bool intersects(const DamageRect &other) const {
+        return minX < other.maxX && other.minX < maxX && minY < other.maxY && other.minY < maxY;
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "damage_tracker.h"
+#include "gameboard_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+DamageTracker::DamageTracker(RedrawMode mode) : 
+    mode(mode), currentFull(true), dirty(true), bufferAge(0)
+{
+    //addRect never goes past MAX_RECTS, so marking and redrawing dont allocate after this
+    this->current.reserve(MAX_RECTS);
+    for (auto &rects : this->history) {
+        rects.reserve(MAX_RECTS);
+    }
+    this->historyFull.fill(true);
+    this->merged.reserve(MAX_RECTS);
+    this->redrawRects.reserve(MAX_RECTS);
+}
+
+void DamageTracker::markFull() {
+    this->currentFull = true;
+    this->dirty = true;
+}
+
+void DamageTracker::markRect(const DamageRect &rect) {
+    if (!this->currentFull) {
+        addRect(this->current, rect);
+    }
+    this->dirty = true;
+}
+
+void DamageTracker::markCell(const GameBoardPos &pos) {
+    GLPos min = GameBoardUtils::translateBoardCoordsToGL(pos);
+    this->markRect({
+        min.x,
+        min.y,
+        min.x + 2.0f / GameBoardUtils::BOARDSIZE.x,
+        min.y + 2.0f / GameBoardUtils::BOARDSIZE.y
+    });
+}
+
+bool DamageTracker::isDirty() const {
+    return this->mode == RedrawMode::Always || this->dirty;
+}
+
+DamageTracker::RedrawMode DamageTracker::getMode() const {
+    return this->mode;
+}
+
+void DamageTracker::setBufferAge(int age) {
+    this->bufferAge = age;
+}
+
+const std::vector<ScissorRect>& DamageTracker::beginRedraw(int fbWidth, int fbHeight) {
+    this->redrawRects.clear();
+    if (this->mode != RedrawMode::OnDemandPartial || this->currentFull || this->bufferAge <= 0 || this->bufferAge > MAX_BUFFER_AGE) {
+        return this->redrawRects;
+    }
+
+    //a back buffer of age n is missing this frames damage and that of the n - 1 frames before it
+    this->merged.assign(this->current.begin(), this->current.end());
+    for (int age = 1; age < this->bufferAge; age++) {
+        if (this->historyFull[age - 1]) {
+            return this->redrawRects;
+        }
+        for (const auto &rect : this->history[age - 1]) {
+            addRect(this->merged, rect);
+        }
+    }
+
+    for (const auto &rect : this->merged) {
+        //clamp to the screen and round outwards so partially covered pixels get redrawn too
+        float minX = std::clamp(rect.minX, -1.0f, 1.0f), maxX = std::clamp(rect.maxX, -1.0f, 1.0f);
+        float minY = std::clamp(rect.minY, -1.0f, 1.0f), maxY = std::clamp(rect.maxY, -1.0f, 1.0f);
+
+        int x0 = static_cast<int>(std::floor((minX + 1.0f) * 0.5f * fbWidth));
+        int y0 = static_cast<int>(std::floor((minY + 1.0f) * 0.5f * fbHeight));
+        int x1 = static_cast<int>(std::ceil((maxX + 1.0f) * 0.5f * fbWidth));
+        int y1 = static_cast<int>(std::ceil((maxY + 1.0f) * 0.5f * fbHeight));
+
+        if (x1 > x0 && y1 > y0) {
+            this->redrawRects.push_back({x0, y0, x1 - x0, y1 - y0, {minX, minY, maxX, maxY}});
+        }
+    }
+
+    //everything was offscreen, nothing to draw but we still have to return something non empty
+    if (this->redrawRects.empty()) {
+        this->redrawRects.push_back({0, 0, 0, 0, {0, 0, 0, 0}});
+    }
+    return this->redrawRects;
+}
+
+void DamageTracker::endRedraw() {
+    //rotate instead of move, every vector keeps its capacity
+    for (size_t i = this->history.size() - 1; i > 0; i--) {
+        std::swap(this->history[i], this->history[i - 1]);
+        this->historyFull[i] = this->historyFull[i - 1];
+    }
+    std::swap(this->history[0], this->current);
+    this->historyFull[0] = this->currentFull;
+    this->current.clear();
+    this->currentFull = false;
+    this->dirty = false;
+}
+
+void DamageTracker::addRect(std::vector<DamageRect> &rects, const DamageRect &rect) {
+    for (auto &existing : rects) {
+        if (existing.intersects(rect)) {
+            existing.minX = std::min(existing.minX, rect.minX), existing.minY = std::min(existing.minY, rect.minY);
+            existing.maxX = std::max(existing.maxX, rect.maxX), existing.maxY = std::max(existing.maxY, rect.maxY);
+            return;
+        }
+    }
+
+    if (rects.size() < MAX_RECTS) {
+        rects.push_back(rect);
+        return;
+    }
+
+    //too many rects, collapse into the bounding box
+    DamageRect bounds = rect;
+    for (const auto &existing : rects) {
+        bounds.minX = std::min(bounds.minX, existing.minX), bounds.minY = std::min(bounds.minY, existing.minY);
+        bounds.maxX = std::max(bounds.maxX, existing.maxX), bounds.maxY = std::max(bounds.maxY, existing.maxY);
+    }
+    rects.clear();
+    rects.push_back(bounds);
+}
@@ -0,0 +1,72 @@
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include <array>
+#include <vector>
+#include "damage_rect.h"
+#include "gameboard_utils.h"
+
+//rect in framebuffer pixels, ready for glScissor
+struct ScissorRect {
+    int x, y;
+    int width, height;
+    DamageRect screenRect;
+};
+
+class DamageTracker {
+    public:
+        enum class RedrawMode {
+            Always,             //redraw every frame, tracking is ignored
+            OnDemand,           //only redraw when something got marked, always the full frame
+            OnDemandPartial     //only redraw the damaged rects, scissored. Needs setBufferAge every frame, see BufferAge
+        };
+
+        //oldest back buffer partial redraws can catch up, older (or unknown) ones get redrawn whole
+        static constexpr int MAX_BUFFER_AGE = 4;
+
+        DamageTracker(RedrawMode mode);
+
+        void markFull();
+        void markRect(const DamageRect &rect);
+        void markCell(const GameBoardPos &pos);
+
+        bool isDirty() const;
+        RedrawMode getMode() const;
+
+        /** 
+         * How many frames ago the back buffer were about to draw into was last drawn, as reported by 
+         * EGL_EXT_buffer_age / GLX_EXT_buffer_age. 0 means its contents are undefined, which is also the default, 
+         * swapchains dont guarantee anything about the back buffer without that extension
+         * */
+        void setBufferAge(int age);
+
+        /** 
+         * Returns the rects that need redrawing this frame, empty means redraw everything.
+         * The damage of the frames since the back buffer was last drawn is included as well
+         * */
+        const std::vector<ScissorRect>& beginRedraw(int fbWidth, int fbHeight);
+        //call after the frame got swapped
+        void endRedraw();
+
+    private:
+        //past this many rects its cheaper to just scissor to the bounding box
+        static constexpr size_t MAX_RECTS = 8;
+
+        RedrawMode mode;
+
+        std::vector<DamageRect> current;
+        //damage of the last few frames, history[0] is the previous one
+        std::array<std::vector<DamageRect>, MAX_BUFFER_AGE - 1> history;
+        std::array<bool, MAX_BUFFER_AGE - 1> historyFull;
+        //current plus the history the back buffer is missing, only used inside beginRedraw
+        std::vector<DamageRect> merged;
+        bool currentFull;
+        bool dirty;
+        int bufferAge;
+
+        std::vector<ScissorRect> redrawRects;
+
+        static void addRect(std::vector<DamageRect> &rects, const DamageRect &rect);
+};
+
+#endif
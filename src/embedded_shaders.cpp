@@ -0,0 +1,54 @@
+#include "embedded_shaders.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#ifdef GLTEMPLATE_SHADER_DIR
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#endif
+
+std::optional<std::string_view> EmbeddedShaders::find(std::string_view name) {
+#ifdef GLTEMPLATE_SHADER_DIR
+    //dev override, read fresh every call so edits show up. Every version read is kept around so the returned views stay valid
+    static std::mutex diskShadersMutex;
+    static std::unordered_map<std::string, std::deque<std::string>> diskShaders;
+
+    std::ifstream file(std::string(GLTEMPLATE_SHADER_DIR) + "/" + std::string(name));
+    if (file.is_open()) {
+        std::stringstream fileBuff;
+        fileBuff << file.rdbuf();
+        std::string source = fileBuff.str();
+
+        std::lock_guard<std::mutex> lock(diskShadersMutex);
+        auto &versions = diskShaders[std::string(name)];
+        if (versions.empty() || versions.back() != source) {
+            versions.push_back(std::move(source));
+        }
+        return versions.back();
+    }
+#endif
+
+    auto shaders = all();
+    auto it = std::lower_bound(shaders.begin(), shaders.end(), name, [](const EmbeddedShader &shader, std::string_view name) {
+        return shader.name < name;
+    });
+
+    if (it == shaders.end() || it->name != name) {
+        return std::nullopt;
+    }
+    return it->source;
+}
+
+std::string_view EmbeddedShaders::get(std::string_view name) {
+    auto source = find(name);
+    if (!source) {
+        throw std::runtime_error(std::format("No embedded shader named: {}", name));
+    }
+    return *source;
+}
@@ -0,0 +1,29 @@
+#ifndef EMBEDDED_SHADERS_H
+#define EMBEDDED_SHADERS_H
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+struct EmbeddedShader {
+    std::string_view name;
+    std::string_view source;
+};
+
+/** 
+ * Shaders from src/shaders, compiled into the library by cmake/embed_shaders.cmake.
+ * Configure with -DGLTEMPLATE_SHADER_DISK_OVERRIDE=ON to read them from the source tree instead while iterating on them
+ * */
+class EmbeddedShaders {
+    public:
+        //generated, sorted by name
+        static std::span<const EmbeddedShader> all();
+
+        //thread safe, with the disk override every call rereads the file
+        static std::optional<std::string_view> find(std::string_view name);
+
+        //throws if theres no shader with that name
+        static std::string_view get(std::string_view name);
+};
+
+#endif
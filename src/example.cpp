@@ -1,11 +1,36 @@
 #include "vao_wrapper.h"
+#include "gl_resources.h"
+#include "gl_deletion_queue.h"
 #include "color.h"
 #include "square.h"
 #include "gameboard_utils.h"
+#include "frame_pacer.h"
+#include "damage_tracker.h"
+#include "shader_cache.h"
+#include "shader_compiler.h"
+#include "shader_watcher.h"
+#include "shader_preprocessor.h"
+#include "gl_loader.h"
+#include "startup_pipeline.h"
+#include "example_world.h"
+#include "input_log.h"
+#include "input_queue.h"
+#include "latency_tracker.h"
+#include "late_latch_buffer.h"
+#include "frame_arena.h"
+#include "allocation_counter.h"
+#include "buffer_age.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <format>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <shader.h>
 #include <vector>
 
@@ -18,102 +43,402 @@ extern "C" {
 
 #define DEFAULT_WINDOW_WIDTH 800
 #define DEFAULT_WINDOW_HEIGHT 800
+#define DEFAULT_TARGET_FPS 60
+#define INPUT_HASH_INTERVAL_TICKS 60
+#define LATE_LATCH_SLOTS 2
+#define ALLOCATION_WARMUP_FRAMES 2
 
-#define VERTEX_SHADER_PATH "../src/shaders/shader.vert"
-#define FRAG_SHADER_PATH "../src/shaders/shader.frag"
+#define VERTEX_SHADER_NAME "shader.vert"
+#define FRAG_SHADER_NAME "shader.frag"
+
+//what the glfw callbacks need, set as the window user pointer
+struct WindowState {
+    DamageTracker *damageTracker;
+    InputQueue *inputQueue;
+};
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
-}
 
-void process_input(GLFWwindow* window) {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, true);
+    auto state = static_cast<WindowState*>(glfwGetWindowUserPointer(window));
+    if (state && state->damageTracker) {
+        state->damageTracker->markFull();
     }
 }
 
+//input callbacks only queue events, the simulation applies them on its next tick
+void key_callback(GLFWwindow* window, int key, int /*scancode*/, int action, int mods) {
+    auto state = static_cast<WindowState*>(glfwGetWindowUserPointer(window));
+    state->inputQueue->push(InputEvent{InputEvent::Type::Key, key, action, mods, 0, 0, glfwGetTime()});
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    auto state = static_cast<WindowState*>(glfwGetWindowUserPointer(window));
+    state->inputQueue->push(InputEvent{InputEvent::Type::MouseButton, button, action, mods, 0, 0, glfwGetTime()});
+}
+
+void cursor_pos_callback(GLFWwindow* window, double x, double y) {
+    auto state = static_cast<WindowState*>(glfwGetWindowUserPointer(window));
+    state->inputQueue->push(InputEvent{InputEvent::Type::CursorPos, 0, 0, 0, x, y, glfwGetTime()});
+}
+
+void scroll_callback(GLFWwindow* window, double xOffset, double yOffset) {
+    auto state = static_cast<WindowState*>(glfwGetWindowUserPointer(window));
+    state->inputQueue->push(InputEvent{InputEvent::Type::Scroll, 0, 0, 0, xOffset, yOffset, glfwGetTime()});
+}
+
 int exampleMain() {
-    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
-    if (!glfwInit()) {
-        const char* description;
-        int code = glfwGetError(&description);
-        throw std::runtime_error(std::string("Failed to initilze glfw: ") + std::string(description));
-    }
+    StartupPipeline startup;
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    GLFWwindow* window = glfwCreateWindow(DEFAULT_WINDOW_WIDTH , DEFAULT_WINDOW_HEIGHT, "OpenGL Template", NULL, NULL);
-    if (window == NULL) {
-        glfwTerminate();
-        throw std::runtime_error("Failed to create a window");
-    }
-    glfwMakeContextCurrent(window);
+    //bake the board dimensions in instead of passing them as uniforms
+    ShaderDefines shaderDefines = {
+        {"BOARD_SIZE_X", std::to_string(GameBoardUtils::BOARDSIZE.x)},
+        {"BOARD_SIZE_Y", std::to_string(GameBoardUtils::BOARDSIZE.y)},
+        {"BOARD_SIZE_Z", std::to_string(GameBoardUtils::BOARDSIZE.z)}
+    };
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        glfwTerminate();
-        throw std::runtime_error("Failed to load glad");
+    //GLTEMPLATE_LATE_LATCH=1 uses the LATE_LATCH shader variant, input offsets get written right before the draw calls
+    const bool lateLatchEnabled = std::getenv("GLTEMPLATE_LATE_LATCH") != nullptr;
+    if (lateLatchEnabled) {
+        shaderDefines["LATE_LATCH"] = "1";
+        shaderDefines["LATE_LATCH_SLOTS"] = std::to_string(LATE_LATCH_SLOTS);
     }
 
+    //cpu only work, runs while the window and context get created below
+    auto shaderSources = startup.runAsync("shader preprocess", [shaderDefines]() {
+        ShaderPreprocessor shaderPreprocessor;
+        return std::array<PreprocessedShader, 2>{
+            shaderPreprocessor.process(VERTEX_SHADER_NAME, shaderDefines),
+            shaderPreprocessor.process(FRAG_SHADER_NAME, shaderDefines)
+        };
+    });
+
+    auto squareMesh = startup.runAsync("mesh build", []() {
+        return MeshData{
+            {
+                0.5f,  0.5f, 0.0f,  // top right
+                0.5f, -0.5f, 0.0f,  // bottom right
+                -0.5f, -0.5f, 0.0f,  // bottom left
+                -0.5f,  0.5f, 0.0f   // top left 
+            },
+            {        
+                0, 1, 3,   // first triangle
+                1, 2, 3    // second triangle
+            }
+        };
+    });
+
+    GLFWwindow* window = startup.runSerial("window + context", []() {
+        auto contextStart = std::chrono::steady_clock::now();
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
+        if (!glfwInit()) {
+            const char* description;
+            int code = glfwGetError(&description);
+            throw std::runtime_error(std::string("Failed to initilze glfw: ") + std::string(description));
+        }
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        GLFWwindow* window = glfwCreateWindow(DEFAULT_WINDOW_WIDTH , DEFAULT_WINDOW_HEIGHT, "OpenGL Template", NULL, NULL);
+        if (window == NULL) {
+            glfwTerminate();
+            throw std::runtime_error("Failed to create a window");
+        }
+        glfwMakeContextCurrent(window);
+        GLLoader::recordContextCreation(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - contextStart).count());
+        return window;
+    });
+
+    startup.runSerial("gl load", []() {
+        //only resolve what we call, when we first call it
+        if (!GLLoader::load(GLLoader::Mode::Lazy))
+        {
+            glfwTerminate();
+            throw std::runtime_error("Failed to load glad");
+        }
+    });
+
     glViewport(0, 0, DEFAULT_WINDOW_WIDTH , DEFAULT_WINDOW_HEIGHT);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    auto shader = std::make_shared<Shader>(VERTEX_SHADER_PATH, FRAG_SHADER_PATH);
+    FramePacer pacer(DEFAULT_TARGET_FPS, FramePacer::VsyncMode::Adaptive);
+    pacer.applyVsync();
+
+    //scissored redraws only when the swapchain tells us whats still in the back buffer
+    auto damageTracker = std::make_shared<DamageTracker>(BufferAge::isSupported() ? 
+            DamageTracker::RedrawMode::OnDemandPartial : DamageTracker::RedrawMode::OnDemand);
+    auto inputQueue = std::make_unique<InputQueue>();
+    WindowState windowState{damageTracker.get(), inputQueue.get()};
+    glfwSetWindowUserPointer(window, &windowState);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_pos_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    //owns every GL object below, everything else just holds handles
+    GLResources resources;
+
+    auto shaderCache = std::make_shared<ShaderCache>(ShaderCache::defaultDirectory());
+    ShaderCompiler shaderCompiler(resources, shaderCache);
 
-    auto vertices = std::make_shared<std::vector<float>>(std::vector<float>{
-        0.5f,  0.5f, 0.0f,  // top right
-        0.5f, -0.5f, 0.0f,  // bottom right
-        -0.5f, -0.5f, 0.0f,  // bottom left
-        -0.5f,  0.5f, 0.0f   // top left 
+    auto pendingShader = startup.runSerial("shader submit", [&]() {
+        const auto &sources = startup.wait("shader preprocess", shaderSources);
+        return shaderCompiler.submit(ShaderSource{sources[0].source, sources[1].source});
     });
 
-    auto indices = std::make_shared<std::vector<unsigned int>>(std::vector<unsigned int>{        
-        0, 1, 3,   // first triangle
-        1, 2, 3    // second triangle
-    }); 
-    auto vao = std::make_shared<VaoWrapper>(vertices, indices);
+    //buffers get uploaded while the driver is compiling, we only block on the program after
+    auto vao = startup.runSerial("buffer upload", [&]() {
+        return resources.getVaos().create(startup.wait("mesh build", squareMesh));
+    });
+
+    auto shader = startup.runSerial("shader link", [&]() {
+        return pendingShader->get();
+    });
+    std::cout << std::format("shader ready in {:.3f}ms ({})\n", resources.get(shader).getBuildTimeMs(), 
+            resources.get(shader).wasLoadedFromCache() ? "warm, binary cache hit" : "cold, compiled from source");
+
+#ifdef GLTEMPLATE_SHADER_DIR
+    //shaders come from the source tree in this build, so reload them when they get edited
+    auto shaderWatcher = std::make_unique<ShaderWatcher>(window, resources, GLTEMPLATE_SHADER_DIR);
+    shaderWatcher->watch(shader, VERTEX_SHADER_NAME, FRAG_SHADER_NAME, shaderDefines);
+#endif
+
+    std::unique_ptr<LateLatchBuffer> lateLatch;
+    if (lateLatchEnabled) {
+        lateLatch = std::make_unique<LateLatchBuffer>(LATE_LATCH_SLOTS);
+        resources.get(shader).bindUniformBlock(LateLatchBuffer::BLOCK_NAME, LateLatchBuffer::BINDING);
+        std::cout << std::format("late latching ({})\n", lateLatch->isPersistent() ? "persistently mapped" : "map per frame");
+    }
+
+    //GLTEMPLATE_MEASURE_LATENCY=1 reports input to present latency on exit
+    std::unique_ptr<LatencyTracker> latencyTracker;
+    if (std::getenv("GLTEMPLATE_MEASURE_LATENCY")) {
+        latencyTracker = std::make_unique<LatencyTracker>();
+    }
+
+    ExampleWorld world;
+
+    //GLTEMPLATE_RECORD_INPUT=path records this session for InputReplay
+    std::unique_ptr<InputRecorder> inputRecorder;
+    if (const char *recordPath = std::getenv("GLTEMPLATE_RECORD_INPUT")) {
+        inputRecorder = std::make_unique<InputRecorder>(recordPath, ExampleWorld::TICK_RATE, INPUT_HASH_INTERVAL_TICKS);
+    }
 
     Color color(255, 100, 25);
 
-    GameBoardPos squareOnePos{0, 0, 0};
-    Square squareOne(vao, shader, std::move(color.getPrepared()), GameBoardUtils::translateBoardCoordsToGL(squareOnePos));
+    GameBoardPos squareOnePos = world.getSquareOnePos();
+    Square squareOne(resources, vao, shader, std::move(color.getPrepared()), GameBoardUtils::translateBoardCoordsToGL(squareOnePos));
 
     color.modify(25, 50, 25);
     
-    GameBoardPos squareTwoPos{9, 9, 0};
-    Square squareTwo(vao, shader, std::move(color.getPrepared()), GameBoardUtils::translateBoardCoordsToGL(squareTwoPos));
+    GameBoardPos squareTwoPos = world.getSquareTwoPos();
+    Square squareTwo(resources, vao, shader, std::move(color.getPrepared()), GameBoardUtils::translateBoardCoordsToGL(squareTwoPos));
 
-    MovVector movementOneVec{1, 1, 0};
-    MovVector movementTwoVec{-1, -1, 0};
+    squareOne.setDamageTracker(damageTracker);
+    squareTwo.setDamageTracker(damageTracker);
+    if (lateLatch) {
+        squareOne.setLatchSlot(0);
+        squareTwo.setLatchSlot(1);
+    }
+    std::array<Square*, 2> squares = {&squareOne, &squareTwo};
 
     long framecount = 0;
+    uint64_t tick = 0;
+    std::vector<InputEvent> inputEvents;
+    const double simStartTime = glfwGetTime();
+    auto tickTime = [simStartTime](uint64_t tick) {
+        return simStartTime + static_cast<double>(tick) / ExampleWorld::TICK_RATE;
+    };
+
+    //transient strings and containers for one loop iteration
+    FrameArena &frameArena = FrameArena::local();
+    uint64_t frameAllocationStart = AllocationCounter::getCount();
+    uint64_t steadyStateAllocations = 0;
+    uint64_t steadyStateFrames = 0;
+    //idle iterations count too, otherwise what they allocate lands on the next frame that renders
+    auto countAllocations = [&]() {
+        uint64_t allocationCount = AllocationCounter::getCount();
+        if (framecount > ALLOCATION_WARMUP_FRAMES) {
+            steadyStateAllocations += allocationCount - frameAllocationStart;
+        }
+        frameAllocationStart = allocationCount;
+    };
+
+    //inputEvents before latchedCount were already shown (and measured) through the late latch
+    size_t latchedCount = 0;
+    auto trackInputs = [&](size_t from) {
+        if (!latencyTracker) {
+            return;
+        }
+        double now = glfwGetTime();
+        for (size_t i = from; i < inputEvents.size(); i++) {
+            if (inputEvents[i].action == GLFW_PRESS && world.getActions().isBound(inputEvents[i])) {
+                latencyTracker->addInput(inputEvents[i].time, now);
+            }
+        }
+    };
+
     while(!glfwWindowShouldClose(window))
     {
-        std::cout << "frameCount: " << framecount++ << "\n";
-        // squareOnePos.y += 1 % GameBoardUtils::BOARDSIZE.y;
-        if (framecount % 100 == 0) {
-            squareOne.translatePos(GameBoardUtils::translateMovVecToGL(movementOneVec));
-            squareTwo.translatePos(GameBoardUtils::translateMovVecToGL(movementTwoVec));
-        }
+        frameArena.reset();
 
         //process logic
-        process_input(window);
+        inputQueue->drain(inputEvents);
+
+        //fixed ticks, input lands on the next tick so a replay applies it on the same one
+        uint64_t targetTick = static_cast<uint64_t>((glfwGetTime() - simStartTime) * ExampleWorld::TICK_RATE);
+        while (tick < targetTick) {
+            if (inputRecorder) {
+                for (const auto &event : inputEvents) {
+                    inputRecorder->record(tick, event);
+                }
+            }
+            trackInputs(latchedCount);
+            world.step(tick, inputEvents);
+            inputEvents.clear();
+            latchedCount = 0;
+            if (inputRecorder) {
+                inputRecorder->endTick(tick, world.hash());
+            }
+            tick++;
+        }
+
+        if (world.wantsQuit()) {
+            glfwSetWindowShouldClose(window, true);
+        }
+
+        auto updateSquare = [](Square &square, GameBoardPos &shownPos, const GameBoardPos &pos) {
+            if (shownPos.x != pos.x || shownPos.y != pos.y || shownPos.z != pos.z) {
+                shownPos = pos;
+                square.setPos(GameBoardUtils::translateBoardCoordsToGL(pos));
+            }
+        };
+        updateSquare(squareOne, squareOnePos, world.getSquareOnePos());
+        updateSquare(squareTwo, squareTwoPos, world.getSquareTwoPos());
+
+#ifdef GLTEMPLATE_SHADER_DIR
+        if (shaderWatcher->poll()) {
+            //the reloaded program is freshly linked, block bindings start over at their defaults
+            if (lateLatch) {
+                resources.get(shader).bindUniformBlock(LateLatchBuffer::BLOCK_NAME, LateLatchBuffer::BINDING);
+            }
+            damageTracker->markFull();
+        }
+#endif
+
+        //nothing changed, sleep until the next event or the next scheduled move (or the next tick if input is waiting for one)
+        if (!damageTracker->isDirty()) {
+            //tick t gets stepped once t + 1 ticks worth of time has passed
+            uint64_t wakeTick = inputEvents.empty() ? world.nextMoveTick(tick) : tick;
+            glfwWaitEventsTimeout(std::max(tickTime(wakeTick + 1) - glfwGetTime(), 0.0));
+            pacer.markIdle();
+            countAllocations();
+            continue;
+        }
+
+        std::cout << "frameCount: " << framecount++ << "\n";
 
         //rendering
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        if (lateLatch) {
+            //the latch can move things after the damage was worked out, so it always redraws everything
+            damageTracker->markFull();
+        }
+        damageTracker->setBufferAge(BufferAge::query());
+        const auto &redrawRects = damageTracker->beginRedraw(fbWidth, fbHeight);
+
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
 
-        //Color stuff            
-        squareOne.draw();
-        squareTwo.draw();
+        if (lateLatch) {
+            //last chance for input to make it into this frame
+            inputQueue->drain(inputEvents);
+            MovVector latchedMovement = world.previewSquareOneMovement(inputEvents);
+            lateLatch->set(0, GameBoardUtils::translateMovVecToGL(latchedMovement));
+            lateLatch->latch();
+            trackInputs(latchedCount);
+            latchedCount = inputEvents.size();
+        }
+
+        if (redrawRects.empty()) {
+            glClear(GL_COLOR_BUFFER_BIT);
+            for (auto square : squares) {
+                square->draw();
+            }
+        } else {
+            glEnable(GL_SCISSOR_TEST);
+            for (const auto &rect : redrawRects) {
+                glScissor(rect.x, rect.y, rect.width, rect.height);
+                glClear(GL_COLOR_BUFFER_BIT);
+                for (auto square : squares) {
+                    if (square->getBounds().intersects(rect.screenRect)) {
+                        square->draw();
+                    }
+                }
+            }
+            glDisable(GL_SCISSOR_TEST);
+        }
 
+        if (lateLatch) {
+            lateLatch->endFrame();
+        }
+        if (latencyTracker) {
+            latencyTracker->markSubmitted(glfwGetTime());
+        }
         glfwSwapBuffers(window);
+        if (latencyTracker) {
+            latencyTracker->markPresented(glfwGetTime());
+        }
+        damageTracker->endRedraw();
+
+        //anything released this frame is done being drawn with, its GL objects go once the GPU is past this frame
+        resources.collect();
+        GLDeletionQueue::global().endFrame();
+
+        if (framecount == 1) {
+            startup.markFirstFrame();
+            startup.printTimings();
+            std::cout << std::format("context created in {:.3f}ms, GL loaded in {:.3f}ms\n", 
+                    GLLoader::getTimings().contextMs, GLLoader::getTimings().loadMs);
+        }
         glfwPollEvents();    
+
+        pacer.endFrame();
+
+        //with GLTEMPLATE_COUNT_ALLOCATIONS, anything after warm-up is a heap allocation that shouldnt be there
+        if (framecount > ALLOCATION_WARMUP_FRAMES) {
+            steadyStateFrames++;
+        }
+        countAllocations();
+    }
+
+    std::cout << std::format("frame time: mean {:.3f}ms, stddev {:.3f}ms, max {:.3f}ms over {} frames\n", 
+            pacer.getMeanFrameTimeMs(), pacer.getFrameTimeStdDevMs(), pacer.getMaxFrameTimeMs(), pacer.getFrameCount());
+    if (inputQueue->getDroppedCount() > 0) {
+        std::cout << std::format("input queue overflowed, {} events dropped\n", inputQueue->getDroppedCount());
+    }
+    if (latencyTracker) {
+        latencyTracker->printReport();
+    }
+    if (AllocationCounter::isEnabled()) {
+        std::cout << std::format("global operator new calls: {} over {} steady state frames, frame arena high water {} bytes\n", 
+                steadyStateAllocations, steadyStateFrames, frameArena.getHighWaterBytes());
     }
     
     //CleanUp
     {
+#ifdef GLTEMPLATE_SHADER_DIR
+        shaderWatcher.reset();
+#endif
+        lateLatch.reset();
+        if (inputRecorder) {
+            inputRecorder->finish();
+            std::cout << std::format("recorded {} ticks of input\n", tick);
+        }
+        //GL objects have to go while the context is still alive
+        resources.destroyAll();
+        GLDeletionQueue::global().flush();
         glfwTerminate();
     }
     std::cout << "Done\n";
@@ -0,0 +1,84 @@
+#include "example_world.h"
+#include "board_file.h"
+
+#include <algorithm>
+#include <array>
+
+extern "C" {
+#include <GLFW/glfw3.h>
+}
+
+ExampleWorld::ExampleWorld() : 
+    squareOnePos{0, 0, 0}, squareTwoPos{9, 9, 0}, movementOneVec{1, 1, 0}, movementTwoVec{-1, -1, 0}, quit(false)
+{
+    this->actions.bind(Quit, InputEvent::Type::Key, GLFW_KEY_ESCAPE);
+    this->actions.bind(MoveUp, InputEvent::Type::Key, GLFW_KEY_UP);
+    this->actions.bind(MoveUp, InputEvent::Type::Key, GLFW_KEY_W);
+    this->actions.bind(MoveDown, InputEvent::Type::Key, GLFW_KEY_DOWN);
+    this->actions.bind(MoveDown, InputEvent::Type::Key, GLFW_KEY_S);
+    this->actions.bind(MoveLeft, InputEvent::Type::Key, GLFW_KEY_LEFT);
+    this->actions.bind(MoveLeft, InputEvent::Type::Key, GLFW_KEY_A);
+    this->actions.bind(MoveRight, InputEvent::Type::Key, GLFW_KEY_RIGHT);
+    this->actions.bind(MoveRight, InputEvent::Type::Key, GLFW_KEY_D);
+}
+
+void ExampleWorld::step(uint64_t tick, std::span<const InputEvent> events) {
+    this->actions.beginTick();
+    this->actions.apply(events);
+
+    if (this->actions.getPressCount(Quit) > 0) {
+        this->quit = true;
+    }
+    //every press moves one cell, even several within the same tick
+    this->squareOnePos = wrap(this->squareOnePos, this->previewSquareOneMovement(events));
+
+    if (tick > 0 && tick % MOVE_INTERVAL_TICKS == 0) {
+        this->squareOnePos = wrap(this->squareOnePos, this->movementOneVec);
+        this->squareTwoPos = wrap(this->squareTwoPos, this->movementTwoVec);
+    }
+}
+
+MovVector ExampleWorld::previewSquareOneMovement(std::span<const InputEvent> events) const {
+    auto presses = [this, events](Action action) {
+        return static_cast<int>(this->actions.countPresses(action, events));
+    };
+    return MovVector{presses(MoveRight) - presses(MoveLeft), presses(MoveUp) - presses(MoveDown), 0};
+}
+
+const ActionMap& ExampleWorld::getActions() const {
+    return this->actions;
+}
+
+uint64_t ExampleWorld::hash() const {
+    std::array<int32_t, 7> state = {
+        this->squareOnePos.x, this->squareOnePos.y, this->squareOnePos.z,
+        this->squareTwoPos.x, this->squareTwoPos.y, this->squareTwoPos.z,
+        this->quit
+    };
+    return BoardFile::checksum(reinterpret_cast<const std::byte*>(state.data()), sizeof(state));
+}
+
+uint64_t ExampleWorld::nextMoveTick(uint64_t tick) const {
+    return std::max<uint64_t>((tick + MOVE_INTERVAL_TICKS - 1) / MOVE_INTERVAL_TICKS, 1) * MOVE_INTERVAL_TICKS;
+}
+
+GameBoardPos ExampleWorld::getSquareOnePos() const {
+    return this->squareOnePos;
+}
+
+GameBoardPos ExampleWorld::getSquareTwoPos() const {
+    return this->squareTwoPos;
+}
+
+bool ExampleWorld::wantsQuit() const {
+    return this->quit;
+}
+
+GameBoardPos ExampleWorld::wrap(GameBoardPos pos, const MovVector &movement) {
+    //keep the squares on the board so the GL translation stays in range
+    auto &size = GameBoardUtils::BOARDSIZE;
+    pos.x = ((pos.x + movement.x) % size.x + size.x) % size.x;
+    pos.y = ((pos.y + movement.y) % size.y + size.y) % size.y;
+    pos.z = ((pos.z + movement.z) % size.z + size.z) % size.z;
+    return pos;
+}
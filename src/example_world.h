@@ -0,0 +1,53 @@
+#ifndef EXAMPLE_WORLD_H
+#define EXAMPLE_WORLD_H
+
+#include <cstdint>
+#include <span>
+#include "action_map.h"
+#include "gameboard_utils.h"
+#include "input_event.h"
+
+/** 
+ * Simulation state of the example, stepped at a fixed tick rate and only from input events so it can run headless
+ * and replay to the same result
+ * */
+class ExampleWorld {
+    public:
+        static constexpr uint32_t TICK_RATE = 60;
+        static constexpr uint64_t MOVE_INTERVAL_TICKS = 90;        //1.5s
+
+        enum Action : ActionMap::Action {
+            Quit,
+            MoveUp,
+            MoveDown,
+            MoveLeft,
+            MoveRight
+        };
+
+        ExampleWorld();
+
+        void step(uint64_t tick, std::span<const InputEvent> events);
+        uint64_t hash() const;
+        //first tick at or after tick that moves the squares without any input
+        uint64_t nextMoveTick(uint64_t tick) const;
+
+        //how far square one will move once events get stepped, ignoring wrapping. Used for late latching
+        MovVector previewSquareOneMovement(std::span<const InputEvent> events) const;
+        const ActionMap& getActions() const;
+
+        GameBoardPos getSquareOnePos() const;
+        GameBoardPos getSquareTwoPos() const;
+        bool wantsQuit() const;
+
+    private:
+        GameBoardPos squareOnePos;
+        GameBoardPos squareTwoPos;
+        MovVector movementOneVec;
+        MovVector movementTwoVec;
+        bool quit;
+        ActionMap actions;
+
+        static GameBoardPos wrap(GameBoardPos pos, const MovVector &movement);
+};
+
+#endif
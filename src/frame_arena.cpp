@@ -0,0 +1,94 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t blockSize, std::pmr::memory_resource *upstream) : 
+    upstream(upstream), current(0), offset(0), usedInFullBlocks(0), highWater(0), upstreamAllocations(0)
+{
+    this->blocks.reserve(8);
+    this->addBlock(std::max<size_t>(blockSize, 64));
+}
+
+FrameArena::~FrameArena() {
+    this->releaseBlocks();
+}
+
+FrameArena& FrameArena::local() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void FrameArena::reset() {
+    this->highWater = std::max(this->highWater, this->getUsedBytes());
+
+    //needed more than one block this frame, replace them with one big enough for all of it
+    if (this->blocks.size() > 1) {
+        size_t total = this->getCapacity();
+        this->releaseBlocks();
+        this->addBlock(total);
+    }
+    this->current = 0;
+    this->offset = 0;
+    this->usedInFullBlocks = 0;
+}
+
+size_t FrameArena::getUsedBytes() const {
+    return this->usedInFullBlocks + this->offset;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t capacity = 0;
+    for (const auto &block : this->blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+size_t FrameArena::getHighWaterBytes() const {
+    return std::max(this->highWater, this->getUsedBytes());
+}
+
+size_t FrameArena::getUpstreamAllocations() const {
+    return this->upstreamAllocations;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        Block &block = this->blocks[this->current];
+        auto base = reinterpret_cast<uintptr_t>(block.data);
+        size_t aligned = ((base + this->offset + alignment - 1) & ~(alignment - 1)) - base;
+        if (aligned + bytes <= block.size) {
+            this->offset = aligned + bytes;
+            return block.data + aligned;
+        }
+
+        this->usedInFullBlocks += this->offset;
+        this->offset = 0;
+        if (this->current + 1 == this->blocks.size()) {
+            this->addBlock(std::max(block.size * 2, bytes + alignment));
+        }
+        this->current++;
+    }
+}
+
+void FrameArena::do_deallocate(void * /*p*/, size_t /*bytes*/, size_t /*alignment*/) {
+    //everything goes at once in reset()
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void FrameArena::addBlock(size_t size) {
+    auto data = static_cast<std::byte*>(this->upstream->allocate(size, alignof(std::max_align_t)));
+    this->blocks.push_back(Block{data, size});
+    this->upstreamAllocations++;
+}
+
+void FrameArena::releaseBlocks() {
+    for (const auto &block : this->blocks) {
+        this->upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+    this->blocks.clear();
+}
@@ -0,0 +1,57 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/** 
+ * Linear allocator for data that only lives until the end of the frame, use through the std::pmr containers.
+ * deallocate does nothing, reset() rewinds everything at once. Running out grabs another block from upstream, 
+ * the next reset folds them into one block of the combined size so steady state frames dont touch the heap.
+ * Not thread safe, use local() to get the calling threads own arena
+ * */
+class FrameArena : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        //arena of the calling thread, reset it from that thread at the end of its frame
+        static FrameArena& local();
+
+        void reset();
+
+        size_t getUsedBytes() const;
+        size_t getCapacity() const;
+        size_t getHighWaterBytes() const;
+        //number of times this arena had to go upstream, stops growing once warmed up
+        size_t getUpstreamAllocations() const;
+
+    private:
+        struct Block {
+            std::byte *data;
+            size_t size;
+        };
+
+        std::pmr::memory_resource *upstream;
+        std::vector<Block> blocks;
+        size_t current;         //block being bumped
+        size_t offset;          //into blocks[current]
+        size_t usedInFullBlocks;
+        size_t highWater;
+        size_t upstreamAllocations;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+        void addBlock(size_t size);
+        void releaseBlocks();
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+}
+
+FramePacer::FramePacer(double targetFps, VsyncMode vsync) : 
+    vsync(vsync), frameDuration(Clock::duration::zero()), started(false)
+{
+    this->setTargetFps(targetFps);
+    this->resetStats();
+}
+
+void FramePacer::applyVsync() {
+    switch (this->vsync) {
+        case VsyncMode::Off:
+            glfwSwapInterval(0);
+            break;
+        case VsyncMode::On:
+            glfwSwapInterval(1);
+            break;
+        case VsyncMode::Adaptive:
+            //negative interval means late frames swap immediately instead of waiting a whole extra vblank
+            if (glfwExtensionSupported("GLX_EXT_swap_control_tear") || glfwExtensionSupported("WGL_EXT_swap_control_tear")) {
+                glfwSwapInterval(-1);
+            } else {
+                glfwSwapInterval(1);
+            }
+            break;
+    }
+}
+
+void FramePacer::setVsync(VsyncMode vsync) {
+    this->vsync = vsync;
+    this->applyVsync();
+}
+
+void FramePacer::setTargetFps(double targetFps) {
+    if (targetFps <= 0) {
+        this->frameDuration = Clock::duration::zero();
+    } else {
+        this->frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+    }
+    this->started = false;
+}
+
+void FramePacer::endFrame() {
+    if (this->frameDuration != Clock::duration::zero()) {
+        if (!this->started) {
+            this->nextDeadline = Clock::now() + this->frameDuration;
+        } else {
+            this->waitUntil(this->nextDeadline);
+            this->nextDeadline += this->frameDuration;
+
+            //fell more than a frame behind (hitch, breakpoint...), dont try to catch up by rushing frames
+            auto now = Clock::now();
+            if (now > this->nextDeadline) {
+                this->nextDeadline = now + this->frameDuration;
+            }
+        }
+    }
+
+    auto now = Clock::now();
+    if (this->started) {
+        this->recordFrameTime(std::chrono::duration<double, std::milli>(now - this->lastFrameEnd).count());
+    }
+    this->lastFrameEnd = now;
+    this->started = true;
+}
+
+void FramePacer::markIdle() {
+    this->started = false;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    auto sleepUntil = deadline - SPIN_THRESHOLD;
+    if (Clock::now() < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordFrameTime(double frameMs) {
+    this->frameCount++;
+    double delta = frameMs - this->meanMs;
+    this->meanMs += delta / this->frameCount;
+    this->m2Ms += delta * (frameMs - this->meanMs);
+    this->maxMs = std::max(this->maxMs, frameMs);
+}
+
+void FramePacer::resetStats() {
+    this->frameCount = 0;
+    this->meanMs = 0, this->m2Ms = 0, this->maxMs = 0;
+}
+
+uint64_t FramePacer::getFrameCount() const {
+    return this->frameCount;
+}
+
+double FramePacer::getMeanFrameTimeMs() const {
+    return this->meanMs;
+}
+
+double FramePacer::getFrameTimeVarianceMs() const {
+    if (this->frameCount < 2) {
+        return 0;
+    }
+    return this->m2Ms / (this->frameCount - 1);
+}
+
+double FramePacer::getFrameTimeStdDevMs() const {
+    return std::sqrt(this->getFrameTimeVarianceMs());
+}
+
+double FramePacer::getMaxFrameTimeMs() const {
+    return this->maxMs;
+}
@@ -0,0 +1,62 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+
+struct GLFWwindow;
+
+class FramePacer {
+    public:
+        enum class VsyncMode {
+            Off,
+            On,
+            Adaptive        //swap tear if the driver supports it, otherwise behaves like On
+        };
+
+        /** 
+         * targetFps <= 0 disables the limiter (vsync still applies if enabled)
+         * */
+        FramePacer(double targetFps, VsyncMode vsync);
+
+        //needs a current GL context, call again after switching contexts
+        void applyVsync();
+        void setVsync(VsyncMode vsync);
+        void setTargetFps(double targetFps);
+
+        /** 
+         * Call once per frame after glfwSwapBuffers. Sleeps until shortly before the frame deadline, 
+         * then spins the rest of the way so we dont get hit by scheduler wakeup jitter
+         * */
+        void endFrame();
+        //call instead of endFrame when the loop skipped a frame (render on demand), so the idle time isnt counted as a frame
+        void markIdle();
+
+        void resetStats();
+        uint64_t getFrameCount() const;
+        double getMeanFrameTimeMs() const;
+        double getFrameTimeVarianceMs() const;     //in ms^2
+        double getFrameTimeStdDevMs() const;
+        double getMaxFrameTimeMs() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        //how long before the deadline we stop sleeping and start spinning
+        static constexpr std::chrono::microseconds SPIN_THRESHOLD{1000};
+
+        VsyncMode vsync;
+        Clock::duration frameDuration;
+        Clock::time_point nextDeadline;
+        Clock::time_point lastFrameEnd;
+        bool started;
+
+        //welford running stats over frame to frame times
+        uint64_t frameCount;
+        double meanMs, m2Ms, maxMs;
+
+        void waitUntil(Clock::time_point deadline);
+        void recordFrameTime(double frameMs);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "game_board.h"
+#include "checkpointer.h"
+
+#include <cassert>
+
+GameBoard::GameBoard(const GameBoardPos &size) : 
+    size(size), ownedCells(static_cast<uint64_t>(size.x) * size.y * size.z, BoardCell{0, 0, 0, 0}), checkpointer(nullptr)
+{
+    this->cells = this->ownedCells;
+}
+
+GameBoard::GameBoard(const std::filesystem::path &savePath) : 
+    file(std::make_unique<BoardFile>(savePath)), checkpointer(nullptr)
+{
+    this->size = this->file->getSize();
+    this->cells = this->file->getCells();
+}
+
+const GameBoardPos& GameBoard::getSize() const {
+    return this->size;
+}
+
+BoardCell GameBoard::get(const GameBoardPos &pos) {
+    uint64_t index = this->indexOf(pos);
+    if (this->file) {
+        this->file->ensureVerified(index);
+    }
+    return this->cells[index];
+}
+
+void GameBoard::set(const GameBoardPos &pos, BoardCell cell) {
+    uint64_t index = this->indexOf(pos);
+
+    //verify before writing, otherwise the edit would make the chunk look corrupt
+    if (this->file) {
+        this->file->ensureVerified(index);
+    }
+    if (Checkpointer *checkpointer = this->checkpointer.load(std::memory_order_acquire)) {
+        checkpointer->beforeWrite(index);
+    }
+    this->cells[index] = cell;
+
+    auto &visible = GameBoardUtils::BOARDSIZE;
+    if (this->damageTracker && pos.x < visible.x && pos.y < visible.y && pos.z < visible.z) {
+        this->damageTracker->markCell(pos);
+    }
+}
+
+std::span<BoardCell> GameBoard::getCells() {
+    return this->cells;
+}
+
+void GameBoard::save(const std::filesystem::path &path) const {
+    BoardFile::save(path, this->size, this->cells);
+}
+
+void GameBoard::setDamageTracker(std::shared_ptr<DamageTracker> damageTracker) {
+    this->damageTracker = damageTracker;
+}
+
+void GameBoard::attachCheckpointer(Checkpointer *checkpointer) {
+    this->checkpointer.store(checkpointer, std::memory_order_release);
+}
+
+void GameBoard::detachCheckpointer(Checkpointer *checkpointer) {
+    this->checkpointer.compare_exchange_strong(checkpointer, nullptr, std::memory_order_acq_rel);
+}
+
+uint64_t GameBoard::indexOf(const GameBoardPos &pos) const {
+    assert(pos.x >= 0 && pos.y >= 0 && pos.z >= 0 && pos.x < this->size.x && pos.y < this->size.y && pos.z < this->size.z);
+    return (static_cast<uint64_t>(pos.z) * this->size.y + pos.y) * this->size.x + pos.x;
+}
@@ -0,0 +1,52 @@
+#ifndef GAME_BOARD_H
+#define GAME_BOARD_H
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+#include "board_file.h"
+#include "damage_tracker.h"
+#include "gameboard_utils.h"
+
+class Checkpointer;
+
+/** 
+ * Cell storage for the board, either owned in memory or used in place from a mapped save file
+ * */
+class GameBoard {
+    public:
+        GameBoard(const GameBoardPos &size);
+        //O(1), cells get paged in (and checksummed) as theyre touched
+        GameBoard(const std::filesystem::path &savePath);
+
+        const GameBoardPos& getSize() const;
+
+        BoardCell get(const GameBoardPos &pos);
+        //marks the cell damaged if its inside the visible board
+        void set(const GameBoardPos &pos, BoardCell cell);
+
+        //raw access, skips the lazy checksum checks on loaded boards
+        std::span<BoardCell> getCells();
+
+        void save(const std::filesystem::path &path) const;
+        void setDamageTracker(std::shared_ptr<DamageTracker> damageTracker);
+        //set() lets it copy chunks aside while a checkpoint is being written
+        void attachCheckpointer(Checkpointer *checkpointer);
+        //only detaches if checkpointer is the one attached, safe to call from the checkpointers worker thread
+        void detachCheckpointer(Checkpointer *checkpointer);
+
+    private:
+        GameBoardPos size;
+        std::vector<BoardCell> ownedCells;
+        std::unique_ptr<BoardFile> file;
+        std::span<BoardCell> cells;
+
+        std::shared_ptr<DamageTracker> damageTracker;
+        std::atomic<Checkpointer*> checkpointer;
+
+        uint64_t indexOf(const GameBoardPos &pos) const;
+};
+
+#endif
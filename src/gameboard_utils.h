@@ -3,6 +3,9 @@
 
 #include <cassert>
 #include <format>
+#include <iterator>
+#include <memory_resource>
+#include <string>
 
 template<typename T>
 struct Pos {
@@ -60,6 +63,15 @@ class GameBoardUtils {
         static std::string posToString(const MovVector &pos) {
             return std::format("{}, {}, {}", pos.x, pos.y, pos.z);
         }
+
+        //formats into resource instead of the heap, pass FrameArena::local() for strings that only live this frame
+        template<typename T>
+        static std::pmr::string posToString(const Pos<T> &pos, std::pmr::memory_resource *resource) {
+            std::pmr::string out(resource);
+            out.reserve(32);
+            std::format_to(std::back_inserter(out), "{}, {}, {}", pos.x, pos.y, pos.z);
+            return out;
+        }
 };
 
 #endif
@@ -0,0 +1,149 @@
+#include "gl_deletion_queue.h"
+
+#include <utility>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+GLDeletionQueue& GLDeletionQueue::global() {
+    static GLDeletionQueue queue;
+    return queue;
+}
+
+GLDeletionQueue::GLDeletionQueue() : 
+    open{nullptr, {}, {}, {}, {}}, deletedCount(0), deleteCallCount(0)
+{
+}
+
+void GLDeletionQueue::deleteBuffer(unsigned int buffer) {
+    if (buffer == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    this->open.buffers.push_back(buffer);
+}
+
+void GLDeletionQueue::deleteVertexArray(unsigned int vertexArray) {
+    if (vertexArray == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    this->open.vertexArrays.push_back(vertexArray);
+}
+
+void GLDeletionQueue::deleteProgram(unsigned int program) {
+    if (program == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    this->open.programs.push_back(program);
+}
+
+void GLDeletionQueue::deleteShader(unsigned int shader) {
+    if (shader == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    this->open.shaders.push_back(shader);
+}
+
+void GLDeletionQueue::endFrame() {
+    {
+        std::lock_guard<std::mutex> lock(this->openMutex);
+        if (!this->open.empty()) {
+            //swap in a spare batch instead of copying, both keep their capacity
+            Batch next{nullptr, {}, {}, {}, {}};
+            if (!this->spare.empty()) {
+                next = std::move(this->spare.back());
+                this->spare.pop_back();
+            }
+            std::swap(this->open, next);
+            next.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            this->fenced.push_back(std::move(next));
+        }
+    }
+
+    //fences signal in order, so stop at the first one the GPU hasnt reached
+    size_t done = 0;
+    while (done < this->fenced.size()) {
+        GLenum status = glClientWaitSync(this->fenced[done].fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        this->execute(this->fenced[done]);
+        done++;
+    }
+    for (size_t i = 0; i < done; i++) {
+        this->spare.push_back(std::move(this->fenced[i]));
+    }
+    this->fenced.erase(this->fenced.begin(), this->fenced.begin() + done);
+}
+
+void GLDeletionQueue::flush() {
+    for (auto &batch : this->fenced) {
+        glClientWaitSync(batch.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        this->execute(batch);
+    }
+    this->fenced.clear();
+    this->spare.clear();
+
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    this->execute(this->open);
+}
+
+size_t GLDeletionQueue::getPendingCount() {
+    size_t count = 0;
+    for (const auto &batch : this->fenced) {
+        count += batch.size();
+    }
+    std::lock_guard<std::mutex> lock(this->openMutex);
+    return count + this->open.size();
+}
+
+uint64_t GLDeletionQueue::getDeletedCount() const {
+    return this->deletedCount;
+}
+
+uint64_t GLDeletionQueue::getDeleteCallCount() const {
+    return this->deleteCallCount;
+}
+
+void GLDeletionQueue::execute(Batch &batch) {
+    if (!batch.buffers.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(batch.buffers.size()), batch.buffers.data());
+        this->deleteCallCount++;
+    }
+    if (!batch.vertexArrays.empty()) {
+        glDeleteVertexArrays(static_cast<GLsizei>(batch.vertexArrays.size()), batch.vertexArrays.data());
+        this->deleteCallCount++;
+    }
+    //no batched versions of these
+    for (unsigned int program : batch.programs) {
+        glDeleteProgram(program);
+    }
+    for (unsigned int shader : batch.shaders) {
+        glDeleteShader(shader);
+    }
+    this->deleteCallCount += batch.programs.size() + batch.shaders.size();
+    this->deletedCount += batch.size();
+
+    if (batch.fence) {
+        glDeleteSync(batch.fence);
+        batch.fence = nullptr;
+    }
+    batch.buffers.clear();
+    batch.vertexArrays.clear();
+    batch.programs.clear();
+    batch.shaders.clear();
+}
+
+bool GLDeletionQueue::Batch::empty() const {
+    return this->buffers.empty() && this->vertexArrays.empty() && this->programs.empty() && this->shaders.empty();
+}
+
+size_t GLDeletionQueue::Batch::size() const {
+    return this->buffers.size() + this->vertexArrays.size() + this->programs.size() + this->shaders.size();
+}
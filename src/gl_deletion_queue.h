@@ -0,0 +1,65 @@
+#ifndef GL_DELETION_QUEUE_H
+#define GL_DELETION_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+typedef struct __GLsync *GLsync;
+
+/** 
+ * Collects GL object deletions instead of making them on the spot. Destructors can enqueue from any thread at any time,
+ * endFrame() on the GL thread fences what was queued during the frame and deletes earlier batches once their fence 
+ * has signalled, with one glDelete* call per object type. Never waits on the GPU except in flush()
+ * */
+class GLDeletionQueue {
+    public:
+        //the queue every GL object destructor uses
+        static GLDeletionQueue& global();
+
+        GLDeletionQueue();
+
+        GLDeletionQueue(const GLDeletionQueue&) = delete;
+        GLDeletionQueue& operator=(const GLDeletionQueue&) = delete;
+
+        void deleteBuffer(unsigned int buffer);
+        void deleteVertexArray(unsigned int vertexArray);
+        void deleteProgram(unsigned int program);
+        void deleteShader(unsigned int shader);
+
+        //GL thread, once the frames commands are submitted
+        void endFrame();
+        //GL thread, waits for every fence and deletes everything. Call before the context goes away
+        void flush();
+
+        size_t getPendingCount();
+        uint64_t getDeletedCount() const;
+        //glDelete* calls made, buffers and vertex arrays count once per batch
+        uint64_t getDeleteCallCount() const;
+
+    private:
+        struct Batch {
+            GLsync fence;
+            std::vector<unsigned int> buffers;
+            std::vector<unsigned int> vertexArrays;
+            std::vector<unsigned int> programs;
+            std::vector<unsigned int> shaders;
+
+            bool empty() const;
+            size_t size() const;
+        };
+
+        std::mutex openMutex;
+        Batch open;
+
+        //GL thread only from here on, oldest first. Finished batches go back to spare so their capacity gets reused
+        std::vector<Batch> fenced;
+        std::vector<Batch> spare;
+        uint64_t deletedCount;
+        uint64_t deleteCallCount;
+
+        void execute(Batch &batch);
+};
+
+#endif
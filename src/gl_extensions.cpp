@@ -0,0 +1,40 @@
+#include "gl_extensions.h"
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+}
+
+bool GLExtensions::loaded = false;
+
+bool GLExtensions::has(const std::string &name) {
+    auto &exts = extensions();
+    if (!loaded) {
+        exts.clear();
+
+        int count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (int i = 0; i < count; i++) {
+            auto ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (ext) {
+                exts.emplace(ext);
+            }
+        }
+        loaded = true;
+    }
+
+    return exts.contains(name);
+}
+
+void GLExtensions::reset() {
+    loaded = false;
+}
+
+std::unordered_set<std::string>& GLExtensions::extensions() {
+    static std::unordered_set<std::string> exts;
+    return exts;
+}
+
+void* GLExtensions::getProcAddress(const char *name) {
+    return reinterpret_cast<void*>(glfwGetProcAddress(name));
+}
@@ -0,0 +1,33 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <string>
+#include <unordered_set>
+
+class GLExtensions {
+    public:
+        //needs a current context, the extension list gets cached on first call
+        static bool has(const std::string &name);
+
+        //call after switching to a different context
+        static void reset();
+
+        /** 
+         * Loads an entry point glad skipped because the context version is below the one that made it core
+         * (e.g. glProgramBinary from ARB_get_program_binary on a 3.3 context)
+         * */
+        template<typename T>
+        static void loadIfMissing(T &func, const char *name) {
+            if (func == nullptr) {
+                func = reinterpret_cast<T>(getProcAddress(name));
+            }
+        }
+
+    private:
+        static std::unordered_set<std::string>& extensions();
+        static bool loaded;
+
+        static void* getProcAddress(const char *name);
+};
+
+#endif
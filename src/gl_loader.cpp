@@ -0,0 +1,150 @@
+#include "gl_loader.h"
+#include "gl_used_functions.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+}
+
+namespace {
+    //stands in for a glad function pointer until its first call, then replaces itself with the real one
+    template<typename Fn>
+    struct LazyEntry;
+
+    template<typename R, typename... Args>
+    struct LazyEntry<R (APIENTRYP)(Args...)> {
+        using Fn = R (APIENTRYP)(Args...);
+
+        //only safe while one thread uses GL, see GLLoader::resolveAll
+        template<Fn *Slot, const char *Name>
+        static R APIENTRY trampoline(Args... args) {
+            *Slot = reinterpret_cast<Fn>(GLLoader::resolve(Name));
+            return (*Slot)(args...);
+        }
+    };
+
+    //template args need names with static storage, string literals wont do
+#define X(name) constexpr char NAME_gl##name[] = "gl" #name;
+    GL_USED_FUNCTIONS(X)
+#undef X
+}
+
+GLLoader::Timings GLLoader::timings = {0, 0, 0};
+std::atomic<int> GLLoader::lazyResolved = 0;
+
+bool GLLoader::load(Mode mode) {
+    auto start = std::chrono::steady_clock::now();
+
+    bool success = true;
+    switch (mode) {
+        case Mode::Full:
+            success = gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+            timings.resolvedAtLoad = -1;
+            break;
+        case Mode::Minimal:
+            success = loadVersion();
+            if (success) {
+                loadMinimal();
+            }
+            break;
+        case Mode::Lazy:
+            success = loadVersion();
+            if (success) {
+                loadLazy();
+            }
+            break;
+    }
+
+    timings.loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return success;
+}
+
+void GLLoader::recordContextCreation(double ms) {
+    timings.contextMs = ms;
+}
+
+const GLLoader::Timings& GLLoader::getTimings() {
+    return timings;
+}
+
+int GLLoader::getLazyResolvedCount() {
+    return lazyResolved;
+}
+
+void* GLLoader::resolve(const char *name) {
+    auto func = reinterpret_cast<void*>(glfwGetProcAddress(name));
+    if (func == nullptr) {
+        throw std::runtime_error(std::format("Failed to resolve GL function: {}", name));
+    }
+    lazyResolved++;
+    return func;
+}
+
+void GLLoader::resolveAll() {
+#define X(name) \
+    if (glad_gl##name == &LazyEntry<decltype(glad_gl##name)>::template trampoline<&glad_gl##name, NAME_gl##name>) { \
+        glad_gl##name = reinterpret_cast<decltype(glad_gl##name)>(glfwGetProcAddress("gl" #name)); \
+        lazyResolved += glad_gl##name != nullptr; \
+    }
+    GL_USED_FUNCTIONS(X)
+#undef X
+}
+
+bool GLLoader::loadVersion() {
+    //same as glads find_coreGL, which is static so we cant reuse it
+    glad_glGetString = reinterpret_cast<PFNGLGETSTRINGPROC>(glfwGetProcAddress("glGetString"));
+    if (glad_glGetString == nullptr) {
+        return false;
+    }
+
+    auto version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (version == nullptr) {
+        return false;
+    }
+
+    int major = 0, minor = 0;
+    if (std::sscanf(version, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    GLVersion.major = major, GLVersion.minor = minor;
+
+    auto atLeast = [major, minor](int wantMajor, int wantMinor) {
+        return major > wantMajor || (major == wantMajor && minor >= wantMinor);
+    };
+    GLAD_GL_VERSION_1_0 = atLeast(1, 0), GLAD_GL_VERSION_1_1 = atLeast(1, 1), GLAD_GL_VERSION_1_2 = atLeast(1, 2);
+    GLAD_GL_VERSION_1_3 = atLeast(1, 3), GLAD_GL_VERSION_1_4 = atLeast(1, 4), GLAD_GL_VERSION_1_5 = atLeast(1, 5);
+    GLAD_GL_VERSION_2_0 = atLeast(2, 0), GLAD_GL_VERSION_2_1 = atLeast(2, 1);
+    GLAD_GL_VERSION_3_0 = atLeast(3, 0), GLAD_GL_VERSION_3_1 = atLeast(3, 1), GLAD_GL_VERSION_3_2 = atLeast(3, 2);
+    GLAD_GL_VERSION_3_3 = atLeast(3, 3);
+    GLAD_GL_VERSION_4_0 = atLeast(4, 0), GLAD_GL_VERSION_4_1 = atLeast(4, 1), GLAD_GL_VERSION_4_2 = atLeast(4, 2);
+    GLAD_GL_VERSION_4_3 = atLeast(4, 3), GLAD_GL_VERSION_4_4 = atLeast(4, 4), GLAD_GL_VERSION_4_5 = atLeast(4, 5);
+    GLAD_GL_VERSION_4_6 = atLeast(4, 6);
+    return true;
+}
+
+void GLLoader::loadMinimal() {
+    int resolved = 0;
+#define X(name) \
+    glad_gl##name = reinterpret_cast<decltype(glad_gl##name)>(glfwGetProcAddress("gl" #name)); \
+    resolved += glad_gl##name != nullptr;
+    GL_USED_FUNCTIONS(X)
+#undef X
+    timings.resolvedAtLoad = resolved;
+}
+
+void GLLoader::loadLazy() {
+#define X(name) \
+    glad_gl##name = &LazyEntry<decltype(glad_gl##name)>::template trampoline<&glad_gl##name, NAME_gl##name>;
+    GL_USED_FUNCTIONS(X)
+#undef X
+
+    //already resolved it for the version check
+    glad_glGetString = reinterpret_cast<PFNGLGETSTRINGPROC>(glfwGetProcAddress("glGetString"));
+    timings.resolvedAtLoad = 1;
+}
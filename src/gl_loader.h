@@ -0,0 +1,50 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+#include <atomic>
+
+class GLLoader {
+    public:
+        enum class Mode {
+            Full,       //gladLoadGLLoader, every entry point up to the context version
+            Minimal,    //only the functions the library actually calls (list generated at build time)
+            Lazy        //same list, but each one resolves itself on its first call
+        };
+
+        struct Timings {
+            double contextMs;       //window + context creation, recorded by the caller
+            double loadMs;
+            int resolvedAtLoad;
+        };
+
+        /** 
+         * Needs a current context. Minimal and Lazy leave every function outside the generated list null,
+         * so code calling GL directly outside the library should use Full
+         * */
+        static bool load(Mode mode);
+
+        static void recordContextCreation(double ms);
+        static const Timings& getTimings();
+        //functions the lazy trampolines have resolved so far
+        static int getLazyResolvedCount();
+
+        //used by the trampolines, throws if the driver doesnt have the function
+        static void* resolve(const char *name);
+
+        /** 
+         * Swaps every trampoline that hasnt fired yet for the real function (null if the driver doesnt have it). 
+         * Trampolines patch the shared glad pointers without any synchronization, so call this on the main thread 
+         * before another thread starts using GL. Does nothing outside of Lazy mode
+         * */
+        static void resolveAll();
+
+    private:
+        static Timings timings;
+        static std::atomic<int> lazyResolved;
+
+        static bool loadVersion();
+        static void loadMinimal();
+        static void loadLazy();
+};
+
+#endif
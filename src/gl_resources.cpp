@@ -0,0 +1,72 @@
+#include "gl_resources.h"
+
+#include <format>
+#include <stdexcept>
+
+GLResources::GLResources() : 
+    glThread(std::this_thread::get_id()), shaders("shader"), vaos("vao"), meshes("mesh")
+{
+}
+
+GLResources::~GLResources() {
+    //no thread check here, throwing out of a destructor would just terminate
+    this->shaders.clear();
+    this->vaos.clear();
+    this->meshes.clear();
+}
+
+ResourcePool<Shader>& GLResources::getShaders() {
+    return this->shaders;
+}
+
+ResourcePool<VaoWrapper>& GLResources::getVaos() {
+    return this->vaos;
+}
+
+ResourcePool<MeshData>& GLResources::getMeshes() {
+    return this->meshes;
+}
+
+Shader& GLResources::get(ShaderHandle handle) {
+    return this->shaders.get(handle);
+}
+
+VaoWrapper& GLResources::get(VaoHandle handle) {
+    return this->vaos.get(handle);
+}
+
+MeshData& GLResources::get(MeshHandle handle) {
+    return this->meshes.get(handle);
+}
+
+void GLResources::release(ShaderHandle handle) {
+    this->shaders.release(handle);
+}
+
+void GLResources::release(VaoHandle handle) {
+    this->vaos.release(handle);
+}
+
+void GLResources::release(MeshHandle handle) {
+    this->meshes.release(handle);
+}
+
+size_t GLResources::collect() {
+    this->checkThread("collect");
+    return this->shaders.collect() + this->vaos.collect() + this->meshes.collect();
+}
+
+void GLResources::destroyAll() {
+    this->checkThread("destroyAll");
+    this->shaders.clear();
+    this->vaos.clear();
+    this->meshes.clear();
+}
+
+void GLResources::checkThread(const char *what) const {
+#ifndef NDEBUG
+    if (std::this_thread::get_id() != this->glThread) {
+        throw std::runtime_error(std::format("GLResources::{} called off the GL thread", what));
+    }
+#endif
+}
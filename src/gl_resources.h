@@ -0,0 +1,58 @@
+#ifndef GL_RESOURCES_H
+#define GL_RESOURCES_H
+
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include "resource_pool.h"
+#include "shader.h"
+#include "vao_wrapper.h"
+
+using ShaderHandle = Handle<Shader>;
+using VaoHandle = Handle<VaoWrapper>;
+using MeshHandle = Handle<MeshData>;
+
+static_assert(std::is_trivially_copyable_v<ShaderHandle> && sizeof(ShaderHandle) == 8);
+
+/**
+ * Owns every shader, VAO and cpu side mesh buffer. Everything else holds handles, and releasing one only takes effect
+ * for the GL objects at the next collect(), which the render loop calls once the frame is submitted.
+ * Lives on the GL thread and has to be destroyed (or destroyAll()ed) while the context is still current
+ * */
+class GLResources {
+    public:
+        //records the calling thread as the GL thread
+        GLResources();
+        ~GLResources();
+
+        GLResources(const GLResources&) = delete;
+        GLResources& operator=(const GLResources&) = delete;
+
+        ResourcePool<Shader>& getShaders();
+        ResourcePool<VaoWrapper>& getVaos();
+        ResourcePool<MeshData>& getMeshes();
+
+        Shader& get(ShaderHandle handle);
+        VaoWrapper& get(VaoHandle handle);
+        MeshData& get(MeshHandle handle);
+
+        void release(ShaderHandle handle);
+        void release(VaoHandle handle);
+        void release(MeshHandle handle);
+
+        //safe point, destroys everything released since the last call. GL thread only, returns how many
+        size_t collect();
+        //call before glfwTerminate, every handle goes stale
+        void destroyAll();
+
+    private:
+        std::thread::id glThread;
+
+        ResourcePool<Shader> shaders;
+        ResourcePool<VaoWrapper> vaos;
+        ResourcePool<MeshData> meshes;
+
+        void checkThread(const char *what) const;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef INPUT_EVENT_H
+#define INPUT_EVENT_H
+
+#include <cstdint>
+
+/** 
+ * One input event, codes/actions/mods are the GLFW values
+ * */
+struct InputEvent {
+    enum class Type : uint8_t {
+        Key,
+        MouseButton,
+        CursorPos,
+        Scroll
+    };
+
+    Type type;
+    int32_t code;       //key or mouse button
+    int32_t action;
+    int32_t mods;
+    double x, y;        //cursor position or scroll offset
+    double time;        //glfwGetTime() when it happened
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "input_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    void putVarint(std::vector<std::byte> &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::byte>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::byte>(value));
+    }
+
+    template<typename T>
+    void putRaw(std::vector<std::byte> &out, const T &value) {
+        auto bytes = reinterpret_cast<const std::byte*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    class Reader {
+        public:
+            Reader(std::span<const std::byte> data, const std::filesystem::path &path) : data(data), offset(0), path(path) {}
+
+            bool atEnd() const {
+                return this->offset >= this->data.size();
+            }
+
+            uint64_t varint() {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    uint64_t byte = static_cast<uint64_t>(this->raw<std::byte>());
+                    value |= (byte & 0x7f) << shift;
+                    if (byte < 0x80) {
+                        return value;
+                    }
+                }
+                throw this->fail("bad varint");
+            }
+
+            template<typename T>
+            T raw() {
+                if (this->offset + sizeof(T) > this->data.size()) {
+                    throw this->fail("truncated");
+                }
+                T value;
+                std::memcpy(&value, this->data.data() + this->offset, sizeof(T));
+                this->offset += sizeof(T);
+                return value;
+            }
+
+            std::runtime_error fail(const std::string &why) const {
+                return std::runtime_error(std::format("Input log {} is invalid at byte {}: {}", this->path.string(), this->offset, why));
+            }
+
+        private:
+            std::span<const std::byte> data;
+            size_t offset;
+            const std::filesystem::path &path;
+    };
+
+    int32_t zigzagDecode(uint64_t value) {
+        return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    uint64_t zigzagEncode(int32_t value) {
+        return (static_cast<uint64_t>(static_cast<int64_t>(value)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+    }
+}
+
+InputRecorder::InputRecorder(const std::filesystem::path &path, uint32_t tickRate, uint32_t hashInterval) : 
+    path(path), file(path, std::ios::binary | std::ios::trunc), hashInterval(hashInterval), lastTick(0), tickCount(0), finished(false)
+{
+    if (!this->file.is_open()) {
+        throw std::runtime_error(std::format("File: {} failed to open", path.string()));
+    }
+
+    InputLog::FileHeader header{InputLog::MAGIC, InputLog::VERSION, tickRate, hashInterval};
+    putRaw(this->buffer, header);
+}
+
+InputRecorder::~InputRecorder() {
+    try {
+        this->finish();
+    } catch (const std::exception&) {
+        //nothing sensible to do in a destructor, the log just ends early
+    }
+}
+
+void InputRecorder::record(uint64_t tick, const InputEvent &event) {
+    this->beginRecord(InputLog::RecordKind::Event, tick);
+    this->buffer.push_back(static_cast<std::byte>(event.type));
+    putVarint(this->buffer, zigzagEncode(event.code));
+    putVarint(this->buffer, zigzagEncode(event.action));
+    putVarint(this->buffer, zigzagEncode(event.mods));
+    if (event.type == InputEvent::Type::CursorPos || event.type == InputEvent::Type::Scroll) {
+        putRaw(this->buffer, event.x);
+        putRaw(this->buffer, event.y);
+    }
+    putRaw(this->buffer, event.time);
+
+    if (this->buffer.size() >= FLUSH_BYTES) {
+        this->flush();
+    }
+}
+
+void InputRecorder::endTick(uint64_t tick, uint64_t worldHash) {
+    this->tickCount = tick + 1;
+    if (this->hashInterval == 0 || tick % this->hashInterval != 0) {
+        return;
+    }
+    this->beginRecord(InputLog::RecordKind::Hash, tick);
+    putRaw(this->buffer, worldHash);
+}
+
+void InputRecorder::finish() {
+    if (this->finished) {
+        return;
+    }
+    this->finished = true;
+    this->beginRecord(InputLog::RecordKind::End, std::max(this->tickCount, this->lastTick));
+    this->flush();
+    this->file.close();
+}
+
+void InputRecorder::beginRecord(InputLog::RecordKind kind, uint64_t tick) {
+    if (tick < this->lastTick) {
+        throw std::runtime_error(std::format("Input log {}: tick {} recorded after {}", this->path.string(), tick, this->lastTick));
+    }
+    this->buffer.push_back(static_cast<std::byte>(kind));
+    putVarint(this->buffer, tick - this->lastTick);
+    this->lastTick = tick;
+}
+
+void InputRecorder::flush() {
+    this->file.write(reinterpret_cast<const char*>(this->buffer.data()), this->buffer.size());
+    this->buffer.clear();
+    if (!this->file) {
+        throw std::runtime_error(std::format("Failed to write input log {}", this->path.string()));
+    }
+}
+
+InputReplayer::InputReplayer(const std::filesystem::path &path) : tickCount(0), eventCursor(0), hashCursor(0), verifiedCount(0) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("File: {} failed to open", path.string()));
+    }
+    std::vector<std::byte> data(std::filesystem::file_size(path));
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+    Reader reader(data, path);
+    this->header = reader.raw<InputLog::FileHeader>();
+    if (this->header.magic != InputLog::MAGIC || this->header.version != InputLog::VERSION) {
+        throw reader.fail("bad header");
+    }
+
+    uint64_t tick = 0;
+    bool ended = false;
+    while (!ended) {
+        if (reader.atEnd()) {
+            throw reader.fail("missing end record");
+        }
+        auto kind = static_cast<InputLog::RecordKind>(reader.raw<uint8_t>());
+        tick += reader.varint();
+
+        switch (kind) {
+            case InputLog::RecordKind::Event: {
+                InputEvent event{};
+                event.type = static_cast<InputEvent::Type>(reader.raw<uint8_t>());
+                event.code = zigzagDecode(reader.varint());
+                event.action = zigzagDecode(reader.varint());
+                event.mods = zigzagDecode(reader.varint());
+                if (event.type == InputEvent::Type::CursorPos || event.type == InputEvent::Type::Scroll) {
+                    event.x = reader.raw<double>();
+                    event.y = reader.raw<double>();
+                }
+                event.time = reader.raw<double>();
+                this->events.push_back(event);
+                this->eventTicks.push_back(tick);
+                break;
+            }
+            case InputLog::RecordKind::Hash:
+                this->hashes.emplace_back(tick, reader.raw<uint64_t>());
+                break;
+            case InputLog::RecordKind::End:
+                ended = true;
+                break;
+            default:
+                throw reader.fail("unknown record");
+        }
+    }
+    this->tickCount = tick;
+}
+
+uint32_t InputReplayer::getTickRate() const {
+    return this->header.tickRate;
+}
+
+uint32_t InputReplayer::getHashInterval() const {
+    return this->header.hashInterval;
+}
+
+uint64_t InputReplayer::getTickCount() const {
+    return this->tickCount;
+}
+
+std::span<const InputEvent> InputReplayer::eventsFor(uint64_t tick) {
+    while (this->eventCursor < this->events.size() && this->eventTicks[this->eventCursor] < tick) {
+        this->eventCursor++;
+    }
+    size_t end = this->eventCursor;
+    while (end < this->events.size() && this->eventTicks[end] == tick) {
+        end++;
+    }
+    std::span<const InputEvent> tickEvents(this->events.data() + this->eventCursor, end - this->eventCursor);
+    this->eventCursor = end;
+    return tickEvents;
+}
+
+bool InputReplayer::verify(uint64_t tick, uint64_t worldHash) {
+    while (this->hashCursor < this->hashes.size() && this->hashes[this->hashCursor].first < tick) {
+        this->hashCursor++;
+    }
+    if (this->hashCursor == this->hashes.size() || this->hashes[this->hashCursor].first != tick) {
+        return true;
+    }
+    this->verifiedCount++;
+    return this->hashes[this->hashCursor++].second == worldHash;
+}
+
+uint64_t InputReplayer::getVerifiedCount() const {
+    return this->verifiedCount;
+}
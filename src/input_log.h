@@ -0,0 +1,89 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+#include "input_event.h"
+
+/** 
+ * Binary input log: header, then records of [kind][varint tick delta][payload], ending with an end record at the tick count.
+ * Events are stamped with the simulation tick they were applied on, so replaying the same events on the same ticks
+ * gives the same simulation. Every hashInterval ticks the world hash is stored too, so a replay can tell where it diverged
+ * */
+namespace InputLog {
+    constexpr uint32_t MAGIC = 0x49544c47;      //"GLTI"
+    constexpr uint32_t VERSION = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t tickRate;
+        uint32_t hashInterval;
+    };
+
+    enum class RecordKind : uint8_t {
+        Event = 0,
+        Hash = 1,
+        End = 2
+    };
+}
+
+class InputRecorder {
+    public:
+        InputRecorder(const std::filesystem::path &path, uint32_t tickRate, uint32_t hashInterval);
+        ~InputRecorder();
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        //ticks must not go backwards
+        void record(uint64_t tick, const InputEvent &event);
+        //call once per tick after stepping the world
+        void endTick(uint64_t tick, uint64_t worldHash);
+        //writes the end marker, called by the destructor if it wasnt already
+        void finish();
+
+    private:
+        std::filesystem::path path;
+        std::ofstream file;
+        std::vector<std::byte> buffer;
+        uint32_t hashInterval;
+        uint64_t lastTick;
+        uint64_t tickCount;
+        bool finished;
+
+        void beginRecord(InputLog::RecordKind kind, uint64_t tick);
+        void flush();
+};
+
+class InputReplayer {
+    public:
+        explicit InputReplayer(const std::filesystem::path &path);
+
+        uint32_t getTickRate() const;
+        uint32_t getHashInterval() const;
+        //number of ticks the recording stepped, replay ticks 0 to tickCount - 1
+        uint64_t getTickCount() const;
+
+        /** events recorded for tick, ticks have to be asked for in increasing order */
+        std::span<const InputEvent> eventsFor(uint64_t tick);
+        /** false if a hash was recorded for tick and it doesnt match. ticks have to be asked for in increasing order */
+        bool verify(uint64_t tick, uint64_t worldHash);
+        uint64_t getVerifiedCount() const;
+
+    private:
+        InputLog::FileHeader header;
+        std::vector<InputEvent> events;
+        std::vector<uint64_t> eventTicks;
+        std::vector<std::pair<uint64_t, uint64_t>> hashes;
+        uint64_t tickCount;
+
+        size_t eventCursor, hashCursor;
+        uint64_t verifiedCount;
+};
+
+#endif
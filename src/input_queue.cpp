@@ -0,0 +1,21 @@
+#include "input_queue.h"
+
+InputQueue::InputQueue() : dropped(0) {
+}
+
+void InputQueue::push(const InputEvent &event) {
+    if (!this->queue.push(event)) {
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputQueue::drain(std::vector<InputEvent> &out) {
+    InputEvent event;
+    while (this->queue.pop(event)) {
+        out.push_back(event);
+    }
+}
+
+uint64_t InputQueue::getDroppedCount() const {
+    return this->dropped.load(std::memory_order_relaxed);
+}
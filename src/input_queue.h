@@ -0,0 +1,32 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "input_event.h"
+#include "spsc_queue.h"
+
+/** 
+ * Timestamped input events from the GLFW callbacks to whoever steps the simulation.
+ * One thread pushes (the one polling GLFW), one thread drains
+ * */
+class InputQueue {
+    public:
+        static constexpr size_t CAPACITY = 4096;
+
+        InputQueue();
+
+        //producer side, drops (and counts) the event if the consumer fell behind
+        void push(const InputEvent &event);
+        //consumer side, appends everything queued so far to out
+        void drain(std::vector<InputEvent> &out);
+
+        uint64_t getDroppedCount() const;
+
+    private:
+        SpscQueue<InputEvent, CAPACITY> queue;
+        std::atomic<uint64_t> dropped;
+};
+
+#endif
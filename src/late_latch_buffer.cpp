@@ -0,0 +1,97 @@
+#include "late_latch_buffer.h"
+#include "gl_extensions.h"
+#include "gl_deletion_queue.h"
+
+#include <cstring>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+LateLatchBuffer::LateLatchBuffer(size_t slots) : 
+    ubo(0), slots(slots), region(0), persistentMapping(nullptr), staged(slots * 4, 0.0f), fences{}
+{
+    int alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    size_t blockSize = slots * 4 * sizeof(float);
+    this->regionSize = (blockSize + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &this->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->ubo);
+
+    //decided by version/extension, in lazy loader mode the pointer is never null
+    bool bufferStorage = GLAD_GL_VERSION_4_4 || GLExtensions::has("GL_ARB_buffer_storage");
+    if (bufferStorage) {
+        GLExtensions::loadIfMissing(glad_glBufferStorage, "glBufferStorage");
+    }
+    if (bufferStorage && glad_glBufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_UNIFORM_BUFFER, this->regionSize * FRAMES, nullptr, flags);
+        this->persistentMapping = glMapBufferRange(GL_UNIFORM_BUFFER, 0, this->regionSize * FRAMES, flags);
+    }
+    if (!this->persistentMapping) {
+        glBufferData(GL_UNIFORM_BUFFER, this->regionSize * FRAMES, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+LateLatchBuffer::~LateLatchBuffer() {
+    for (auto fence : this->fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (this->persistentMapping) {
+        glBindBuffer(GL_UNIFORM_BUFFER, this->ubo);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    GLDeletionQueue::global().deleteBuffer(this->ubo);
+}
+
+void LateLatchBuffer::set(size_t slot, const GLPos &offset) {
+    if (slot >= this->slots) {
+        throw std::out_of_range("LateLatchBuffer slot out of range");
+    }
+    this->staged[slot * 4] = offset.x;
+    this->staged[slot * 4 + 1] = offset.y;
+    this->staged[slot * 4 + 2] = offset.z;
+}
+
+void LateLatchBuffer::latch() {
+    //FRAMES behind, so this only ever waits when the GPU is that far behind anyway
+    GLsync &fence = this->fences[this->region];
+    if (fence) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    size_t offset = this->region * this->regionSize;
+    size_t bytes = this->staged.size() * sizeof(float);
+    if (this->persistentMapping) {
+        std::memcpy(static_cast<char*>(this->persistentMapping) + offset, this->staged.data(), bytes);
+    } else {
+        glBindBuffer(GL_UNIFORM_BUFFER, this->ubo);
+        void *mapping = glMapBufferRange(GL_UNIFORM_BUFFER, offset, bytes, 
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapping) {
+            std::memcpy(mapping, this->staged.data(), bytes);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, BINDING, this->ubo, offset, this->regionSize);
+}
+
+void LateLatchBuffer::endFrame() {
+    this->fences[this->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    this->region = (this->region + 1) % FRAMES;
+}
+
+bool LateLatchBuffer::isPersistent() const {
+    return this->persistentMapping != nullptr;
+}
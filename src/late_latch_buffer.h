@@ -0,0 +1,47 @@
+#ifndef LATE_LATCH_BUFFER_H
+#define LATE_LATCH_BUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "gameboard_utils.h"
+
+typedef struct __GLsync *GLsync;
+
+/** 
+ * Uniform block of per object offsets (LateLatch in the LATE_LATCH shader variant) that gets written right before the 
+ * draw calls instead of when the frame starts, so input that arrived while the frame was being built still shows up in it.
+ * Cycles through FRAMES regions fenced per frame, persistently mapped when ARB_buffer_storage is there
+ * */
+class LateLatchBuffer {
+    public:
+        static constexpr unsigned int BINDING = 0;
+        static constexpr size_t FRAMES = 3;
+        static constexpr const char *BLOCK_NAME = "LateLatch";
+
+        //slots has to match LATE_LATCH_SLOTS in the shader
+        explicit LateLatchBuffer(size_t slots);
+        ~LateLatchBuffer();
+
+        LateLatchBuffer(const LateLatchBuffer&) = delete;
+        LateLatchBuffer& operator=(const LateLatchBuffer&) = delete;
+
+        void set(size_t slot, const GLPos &offset);
+        /** copies the offsets into this frames region and binds it, call right before the draw calls */
+        void latch();
+        /** after the frames draw calls, fences the region so it isnt overwritten while the GPU still reads it */
+        void endFrame();
+
+        bool isPersistent() const;
+
+    private:
+        unsigned int ubo;
+        size_t slots;
+        size_t regionSize;
+        size_t region;
+        void *persistentMapping;
+        std::vector<float> staged;      //vec4 per slot, std140
+        std::array<GLsync, FRAMES> fences;
+};
+
+#endif
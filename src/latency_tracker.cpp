@@ -0,0 +1,78 @@
+#include "latency_tracker.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+
+LatencyTracker::LatencyTracker(size_t maxSamples) : submitTime(0), maxSamples(std::max<size_t>(maxSamples, 1)), nextSample(0) {
+    this->samples.reserve(this->maxSamples);
+}
+
+void LatencyTracker::addInput(double inputTime, double applyTime) {
+    this->pending.push_back(PendingInput{inputTime, applyTime});
+}
+
+void LatencyTracker::markSubmitted(double time) {
+    this->submitTime = time;
+}
+
+void LatencyTracker::markPresented(double time) {
+    for (const auto &input : this->pending) {
+        Sample sample{
+            (time - input.inputTime) * 1000.0,
+            (input.applyTime - input.inputTime) * 1000.0,
+            (this->submitTime - input.applyTime) * 1000.0,
+            (time - this->submitTime) * 1000.0
+        };
+
+        //ring once full, percentiles are over the most recent inputs
+        if (this->samples.size() < this->maxSamples) {
+            this->samples.push_back(sample);
+        } else {
+            this->samples[this->nextSample] = sample;
+        }
+        this->nextSample = (this->nextSample + 1) % this->maxSamples;
+    }
+    this->pending.clear();
+}
+
+LatencyTracker::Report LatencyTracker::getReport() const {
+    Report report{this->samples.size(), 0, 0, 0, 0, 0, 0, 0};
+    if (this->samples.empty()) {
+        return report;
+    }
+
+    std::vector<double> totals;
+    totals.reserve(this->samples.size());
+    for (const auto &sample : this->samples) {
+        totals.push_back(sample.totalMs);
+        report.inputToApplyMs += sample.inputToApplyMs;
+        report.applyToSubmitMs += sample.applyToSubmitMs;
+        report.submitToPresentMs += sample.submitToPresentMs;
+    }
+    report.inputToApplyMs /= totals.size();
+    report.applyToSubmitMs /= totals.size();
+    report.submitToPresentMs /= totals.size();
+
+    std::sort(totals.begin(), totals.end());
+    auto percentile = [&totals](double p) {
+        return totals[std::min(static_cast<size_t>(p * totals.size()), totals.size() - 1)];
+    };
+    report.p50Ms = percentile(0.50);
+    report.p90Ms = percentile(0.90);
+    report.p99Ms = percentile(0.99);
+    report.maxMs = totals.back();
+    return report;
+}
+
+void LatencyTracker::printReport() const {
+    Report report = this->getReport();
+    if (report.count == 0) {
+        std::cout << "input latency: no samples\n";
+        return;
+    }
+    std::cout << std::format("input latency over {} inputs: p50 {:.3f}ms, p90 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms\n",
+            report.count, report.p50Ms, report.p90Ms, report.p99Ms, report.maxMs);
+    std::cout << std::format("  mean input -> applied {:.3f}ms, applied -> submitted {:.3f}ms, submitted -> presented {:.3f}ms\n",
+            report.inputToApplyMs, report.applyToSubmitMs, report.submitToPresentMs);
+}
@@ -0,0 +1,53 @@
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <cstddef>
+#include <vector>
+
+/** 
+ * Input to present latency. Every input that makes it into a frame is added with the time it happened and the time
+ * the simulation (or the late latch) used it, the frame then stamps submit and present (glfwSwapBuffers returning).
+ * Keeps the last maxSamples samples. Times are glfwGetTime() seconds
+ * */
+class LatencyTracker {
+    public:
+        struct Report {
+            size_t count;
+            double p50Ms, p90Ms, p99Ms, maxMs;
+            //mean of each stage, they add up to the mean total
+            double inputToApplyMs, applyToSubmitMs, submitToPresentMs;
+        };
+
+        explicit LatencyTracker(size_t maxSamples = 8192);
+
+        void addInput(double inputTime, double applyTime);
+        //after the last draw call of the frame, before swapping
+        void markSubmitted(double time);
+        //after glfwSwapBuffers returned, turns the frames inputs into samples
+        void markPresented(double time);
+
+        Report getReport() const;
+        void printReport() const;
+
+    private:
+        struct PendingInput {
+            double inputTime;
+            double applyTime;
+        };
+
+        struct Sample {
+            double totalMs;
+            double inputToApplyMs;
+            double applyToSubmitMs;
+            double submitToPresentMs;
+        };
+
+        std::vector<PendingInput> pending;
+        double submitTime;
+
+        std::vector<Sample> samples;
+        size_t maxSamples;
+        size_t nextSample;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    //scoring cache size, larger than the simulated one since the scores only have to rank vertices
+    constexpr int SCORE_CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, uint32_t remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            //the triangle just drawn gets a fixed score so it doesnt win just by being in the cache
+            if (cachePosition < 3) {
+                score = LAST_TRIANGLE_SCORE;
+            } else {
+                float scaled = 1.0f - static_cast<float>(cachePosition - 3) / (SCORE_CACHE_SIZE - 3);
+                score = std::pow(scaled, CACHE_DECAY_POWER);
+            }
+        }
+        //vertices with few triangles left get finished off, so they dont have to be fetched again later
+        return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    }
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::computeCacheStats(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize) {
+    //FIFO by timestamp, a vertex is still cached if fewer than cacheSize misses happened since it was loaded
+    std::vector<uint32_t> loadedAt(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t time = static_cast<uint32_t>(cacheSize) + 1;
+    size_t misses = 0, referencedCount = 0;
+
+    for (auto index : indices) {
+        if (index >= vertexCount) {
+            throw std::out_of_range(std::format("Index {} out of range, only {} vertices", index, vertexCount));
+        }
+        if (time - loadedAt[index] > cacheSize) {
+            loadedAt[index] = time++;
+            misses++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            referencedCount++;
+        }
+    }
+
+    size_t triangles = indices.size() / 3;
+    return {
+        triangles > 0 ? static_cast<double>(misses) / triangles : 0.0,
+        referencedCount > 0 ? static_cast<double>(misses) / referencedCount : 0.0
+    };
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<unsigned int> indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    //triangles per vertex, compacted into one array. remaining[v] of them (at the front of vs range) arent emitted yet
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (auto index : indices) {
+        if (index >= vertexCount) {
+            throw std::out_of_range(std::format("Index {} out of range, only {} vertices", index, vertexCount));
+        }
+        remaining[index]++;
+    }
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        score[v] = vertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    size_t best = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) {
+            best = t;
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(SCORE_CACHE_SIZE + 3);
+    nextCache.reserve(SCORE_CACHE_SIZE + 3);
+    size_t scanCursor = 0;
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    while (output.size() < indices.size()) {
+        //nothing in the cache has triangles left, continue with the next unused one in the original order
+        if (best == NONE) {
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            best = scanCursor;
+        }
+
+        const unsigned int *triangle = &indices[best * 3];
+        emitted[best] = true;
+        nextCache.clear();
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = triangle[k];
+            output.push_back(v);
+
+            //swap the triangle out of the remaining part of vs list
+            uint32_t *list = &adjacency[firstTriangle[v]];
+            for (uint32_t i = 0; i < remaining[v]; i++) {
+                if (list[i] == best) {
+                    std::swap(list[i], list[remaining[v] - 1]);
+                    break;
+                }
+            }
+            remaining[v]--;
+
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                nextCache.push_back(v);
+            }
+        }
+        for (auto v : cache) {
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                nextCache.push_back(v);
+            }
+        }
+
+        //whatever fell off the end loses its cache bonus
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            uint32_t v = nextCache[i];
+            cachePosition[v] = i < SCORE_CACHE_SIZE ? static_cast<int>(i) : -1;
+            score[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        //only triangles touching the cache changed score, the best next one is among them (or there is none)
+        best = NONE;
+        float bestScore = -1.0f;
+        for (auto v : nextCache) {
+            const uint32_t *list = &adjacency[firstTriangle[v]];
+            for (uint32_t i = 0; i < remaining[v]; i++) {
+                uint32_t t = list[i];
+                triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        nextCache.resize(std::min<size_t>(nextCache.size(), SCORE_CACHE_SIZE));
+        std::swap(cache, nextCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+size_t MeshOptimizer::optimizeVertexFetch(std::span<std::byte> vertices, size_t stride, std::span<unsigned int> indices) {
+    size_t vertexCount = vertices.size() / stride;
+    constexpr uint32_t UNMAPPED = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertexCount, UNMAPPED);
+
+    uint32_t next = 0;
+    for (auto &index : indices) {
+        if (index >= vertexCount) {
+            throw std::out_of_range(std::format("Index {} out of range, only {} vertices", index, vertexCount));
+        }
+        if (remap[index] == UNMAPPED) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    size_t referenced = next;
+    for (auto &target : remap) {
+        if (target == UNMAPPED) {
+            target = next++;
+        }
+    }
+
+    std::vector<std::byte> original(vertices.begin(), vertices.end());
+    for (size_t v = 0; v < vertexCount; v++) {
+        std::memcpy(vertices.data() + remap[v] * stride, original.data() + v * stride, stride);
+    }
+    return referenced;
+}
+
+MeshOptimizer::Report MeshOptimizer::optimize(MeshData &mesh) {
+    size_t vertexCount = mesh.vertices.size() / 3;
+    Report report{};
+    report.vertexCount = vertexCount;
+    report.before = computeCacheStats(mesh.indices, vertexCount);
+
+    optimizeVertexCache(mesh.indices, vertexCount);
+    optimizeVertexFetch(std::as_writable_bytes(std::span<float>(mesh.vertices)), 3 * sizeof(float), mesh.indices);
+
+    report.after = computeCacheStats(mesh.indices, vertexCount);
+    report.narrowIndices = fitsUnsignedShort(mesh.indices);
+    return report;
+}
+
+bool MeshOptimizer::fitsUnsignedShort(std::span<const unsigned int> indices) {
+    return std::all_of(indices.begin(), indices.end(), [](unsigned int index) { 
+        return index <= std::numeric_limits<uint16_t>::max(); 
+    });
+}
@@ -0,0 +1,52 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "vao_wrapper.h"
+
+/** 
+ * Offline mesh finalization: triangle order for the post transform vertex cache (Forsyth's linear speed algorithm),
+ * vertex order for fetch locality, and 16 bit index narrowing. Meant for build time (ScenePacker) or load time, not per frame
+ * */
+namespace MeshOptimizer {
+    //simulated FIFO cache, the size older hardware actually has
+    constexpr size_t DEFAULT_CACHE_SIZE = 16;
+
+    struct CacheStats {
+        double acmr;    //vertex shader runs per triangle, 0.5 is the best a regular grid can do, 3 the worst
+        double atvr;    //vertex shader runs per referenced vertex, 1 is perfect
+    };
+
+    struct Report {
+        CacheStats before, after;
+        size_t vertexCount;
+        bool narrowIndices;
+    };
+
+    CacheStats computeCacheStats(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    //reorders the triangles in place, throws if an index is out of range
+    void optimizeVertexCache(std::span<unsigned int> indices, size_t vertexCount);
+
+    /** 
+     * Renumbers vertices in the order the indices first use them and moves the vertex data to match, 
+     * unreferenced vertices end up at the back. Returns how many are referenced
+     * */
+    size_t optimizeVertexFetch(std::span<std::byte> vertices, size_t stride, std::span<unsigned int> indices);
+
+    template<VertexType Vertex>
+    size_t optimizeVertexFetch(std::span<Vertex> vertices, std::span<unsigned int> indices) {
+        return optimizeVertexFetch(std::as_writable_bytes(vertices), sizeof(Vertex), indices);
+    }
+
+    //both passes on plain positions, cache order first since fetch order follows the triangles
+    Report optimize(MeshData &mesh);
+
+    //every index fits GL_UNSIGNED_SHORT
+    bool fitsUnsignedShort(std::span<const unsigned int> indices);
+}
+
+#endif
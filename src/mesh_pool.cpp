@@ -0,0 +1,175 @@
+#include "mesh_pool.h"
+#include "gl_deletion_queue.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+MeshPool::MeshPool(uint32_t vertexCapacity, uint32_t indexCapacity, const VertexFormat &format) : 
+    format(format), vao(0), vertexBuf(0), indexBuf(0), vertexRanges(vertexCapacity), indexRanges(indexCapacity), meshes("pooled mesh"), relocations(0)
+{
+    glGenVertexArrays(1, &this->vao);
+    this->createBuffers(vertexCapacity, indexCapacity, this->vertexBuf, this->indexBuf);
+    this->attachBuffers();
+}
+
+MeshPool::~MeshPool() {
+    GLDeletionQueue &deletionQueue = GLDeletionQueue::global();
+    deletionQueue.deleteVertexArray(this->vao);
+    deletionQueue.deleteBuffer(this->vertexBuf);
+    deletionQueue.deleteBuffer(this->indexBuf);
+}
+
+MeshPool::MeshHandle MeshPool::add(std::span<const float> vertices, std::span<const unsigned int> indices) {
+    return this->addBytes(PositionVertex::Layout::format(), std::as_bytes(vertices), indices);
+}
+
+MeshPool::MeshHandle MeshPool::addBytes(const VertexFormat &format, std::span<const std::byte> vertices, std::span<const unsigned int> indices) {
+    if (!format.matches(this->format)) {
+        throw std::runtime_error("Mesh vertex format differs from the pools");
+    }
+    if (vertices.size() % this->format.stride != 0) {
+        throw std::runtime_error(std::format("Mesh has {} bytes of vertices, not a multiple of the {} byte stride", vertices.size(), this->format.stride));
+    }
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size() / this->format.stride);
+    uint32_t indexCount = static_cast<uint32_t>(indices.size());
+
+    if (!this->fits(vertexCount, indexCount)) {
+        if (this->vertexRanges.getFree() >= vertexCount && this->indexRanges.getFree() >= indexCount) {
+            this->defragment();
+        } else {
+            uint32_t vertexCapacity = std::max(this->vertexRanges.getCapacity() * 2, this->vertexRanges.getUsed() + vertexCount);
+            uint32_t indexCapacity = std::max(this->indexRanges.getCapacity() * 2, this->indexRanges.getUsed() + indexCount);
+            this->relocate(vertexCapacity, indexCapacity);
+        }
+    }
+
+    Mesh mesh{*this->vertexRanges.allocate(vertexCount), *this->indexRanges.allocate(indexCount), this->format.computeBounds(vertices)};
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuf);
+    glBufferSubData(GL_ARRAY_BUFFER, mesh.vertices.offset * this->format.stride, vertices.size_bytes(), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    //through the VAO so the element binding of whatever else is bound stays untouched
+    glBindVertexArray(this->vao);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.offset * sizeof(unsigned int), indices.size_bytes(), indices.data());
+    glBindVertexArray(0);
+
+    return this->meshes.create(mesh);
+}
+
+void MeshPool::remove(MeshHandle mesh) {
+    const Mesh &entry = this->meshes.get(mesh);
+    this->vertexRanges.free(entry.vertices);
+    this->indexRanges.free(entry.indices);
+    this->meshes.release(mesh);
+    this->meshes.collect();
+}
+
+const MeshPool::Mesh& MeshPool::get(MeshHandle mesh) const {
+    return this->meshes.get(mesh);
+}
+
+const DamageRect& MeshPool::getBounds(MeshHandle mesh) const {
+    return this->meshes.get(mesh).bounds;
+}
+
+void MeshPool::bind() {
+    glBindVertexArray(this->vao);
+}
+
+void MeshPool::draw(MeshHandle mesh) {
+    const Mesh &entry = this->meshes.get(mesh);
+    glDrawElementsBaseVertex(GL_TRIANGLES, entry.indices.size, GL_UNSIGNED_INT, 
+            reinterpret_cast<void*>(static_cast<uintptr_t>(entry.indices.offset) * sizeof(unsigned int)), entry.vertices.offset);
+}
+
+void MeshPool::unbind() {
+    glBindVertexArray(0);
+}
+
+void MeshPool::defragment() {
+    this->relocate(this->vertexRanges.getCapacity(), this->indexRanges.getCapacity());
+}
+
+MeshPool::Stats MeshPool::getStats() const {
+    return {
+        this->meshes.size(),
+        this->vertexRanges.getCapacity(), this->vertexRanges.getUsed(),
+        this->indexRanges.getCapacity(), this->indexRanges.getUsed(),
+        this->vertexRanges.getFreeRangeCount(), this->indexRanges.getFreeRangeCount(),
+        this->vertexRanges.getFragmentation(), this->indexRanges.getFragmentation(),
+        this->relocations
+    };
+}
+
+void MeshPool::createBuffers(uint32_t vertexCapacity, uint32_t indexCapacity, unsigned int &vertexBuf, unsigned int &indexBuf) {
+    unsigned int bufs[2]{};
+    glGenBuffers(2, bufs);
+    vertexBuf = bufs[0], indexBuf = bufs[1];
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuf);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(vertexCapacity) * this->format.stride, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuf);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indexCapacity) * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshPool::attachBuffers() {
+    glBindVertexArray(this->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuf);
+    this->format.apply();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->indexBuf);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MeshPool::relocate(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    unsigned int newVertexBuf, newIndexBuf;
+    this->createBuffers(vertexCapacity, indexCapacity, newVertexBuf, newIndexBuf);
+
+    //pack everything front to back, GPU side copies only
+    uint32_t vertexEnd = 0, indexEnd = 0;
+    const size_t vertexStride = this->format.stride;
+    this->meshes.forEach([&](MeshHandle, Mesh &mesh) {
+        glBindBuffer(GL_COPY_READ_BUFFER, this->vertexBuf);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newVertexBuf);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+                mesh.vertices.offset * vertexStride, vertexEnd * vertexStride, mesh.vertices.size * vertexStride);
+        glBindBuffer(GL_COPY_READ_BUFFER, this->indexBuf);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newIndexBuf);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+                mesh.indices.offset * sizeof(unsigned int), indexEnd * sizeof(unsigned int), mesh.indices.size * sizeof(unsigned int));
+
+        mesh.vertices.offset = vertexEnd;
+        mesh.indices.offset = indexEnd;
+        vertexEnd += mesh.vertices.size;
+        indexEnd += mesh.indices.size;
+    });
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    //frames in flight may still read the old buffers
+    GLDeletionQueue::global().deleteBuffer(this->vertexBuf);
+    GLDeletionQueue::global().deleteBuffer(this->indexBuf);
+    this->vertexBuf = newVertexBuf;
+    this->indexBuf = newIndexBuf;
+    this->attachBuffers();
+
+    //one used range at the front, removing a mesh frees its part of it
+    this->vertexRanges.reset(vertexCapacity);
+    this->indexRanges.reset(indexCapacity);
+    this->vertexRanges.allocate(vertexEnd);
+    this->indexRanges.allocate(indexEnd);
+    this->relocations++;
+}
+
+bool MeshPool::fits(uint32_t vertexCount, uint32_t indexCount) const {
+    return this->vertexRanges.getLargestFreeRange() >= vertexCount && this->indexRanges.getLargestFreeRange() >= indexCount;
+}
@@ -0,0 +1,84 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "damage_rect.h"
+#include "range_allocator.h"
+#include "resource_pool.h"
+#include "vertex_layout.h"
+
+/** 
+ * Vertex and index data of many small meshes carved out of one vertex buffer and one index buffer, behind a single VAO.
+ * Indices stay relative to their own mesh and get drawn with glDrawElementsBaseVertex, so bind() once and then draw() 
+ * as many meshes as needed without touching any other GL state. One pool per vertex format.
+ * Needs a current context, GL thread only
+ * */
+class MeshPool {
+    public:
+        struct Mesh {
+            RangeAllocator::Range vertices;
+            RangeAllocator::Range indices;
+            DamageRect bounds;
+        };
+        using MeshHandle = Handle<Mesh>;
+
+        struct Stats {
+            size_t meshCount;
+            uint32_t vertexCapacity, vertexUsed;
+            uint32_t indexCapacity, indexUsed;
+            size_t vertexFreeRanges, indexFreeRanges;
+            double vertexFragmentation, indexFragmentation;
+            //times the buffers got compacted or grown, each one copies every live mesh on the GPU
+            uint64_t relocations;
+        };
+
+        MeshPool(uint32_t vertexCapacity, uint32_t indexCapacity, const VertexFormat &format = PositionVertex::Layout::format());
+        ~MeshPool();
+
+        MeshPool(const MeshPool&) = delete;
+        MeshPool& operator=(const MeshPool&) = delete;
+
+        /** 
+         * Compacts first if the space is there but splintered, grows both buffers if it isnt. 
+         * Throws if Vertex isnt laid out like the pools format
+         * */
+        template<VertexType Vertex>
+        MeshHandle add(std::span<const Vertex> vertices, std::span<const unsigned int> indices) {
+            return this->addBytes(Vertex::Layout::format(), std::as_bytes(vertices), indices);
+        }
+        //plain positions, for pools with the default format
+        MeshHandle add(std::span<const float> vertices, std::span<const unsigned int> indices);
+        //the space is reused right away, GL orders the next upload after any draw still reading it
+        void remove(MeshHandle mesh);
+
+        const Mesh& get(MeshHandle mesh) const;
+        //local space, like VaoWrapper::getBounds
+        const DamageRect& getBounds(MeshHandle mesh) const;
+
+        void bind();
+        //pool has to be bound
+        void draw(MeshHandle mesh);
+        void unbind();
+
+        //packs every live mesh to the start of fresh buffers, the old ones go through the deletion queue
+        void defragment();
+
+        Stats getStats() const;
+
+    private:
+        VertexFormat format;
+        unsigned int vao, vertexBuf, indexBuf;
+        RangeAllocator vertexRanges, indexRanges;
+        ResourcePool<Mesh> meshes;
+        uint64_t relocations;
+
+        void createBuffers(uint32_t vertexCapacity, uint32_t indexCapacity, unsigned int &vertexBuf, unsigned int &indexBuf);
+        void attachBuffers();
+        void relocate(uint32_t vertexCapacity, uint32_t indexCapacity);
+        bool fits(uint32_t vertexCount, uint32_t indexCount) const;
+        MeshHandle addBytes(const VertexFormat &format, std::span<const std::byte> vertices, std::span<const unsigned int> indices);
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "range_allocator.h"
+
+#include <format>
+#include <iterator>
+#include <stdexcept>
+
+RangeAllocator::RangeAllocator(uint32_t capacity) {
+    this->reset(capacity);
+}
+
+std::optional<RangeAllocator::Range> RangeAllocator::allocate(uint32_t size) {
+    if (size == 0) {
+        return Range{0, 0};
+    }
+
+    //smallest range that fits, lowest offset among equal sizes
+    auto best = this->freeBySize.lower_bound({size, 0});
+    if (best == this->freeBySize.end()) {
+        return std::nullopt;
+    }
+
+    auto [freeSize, offset] = *best;
+    this->eraseFree(this->freeByOffset.find(offset));
+    if (freeSize > size) {
+        this->insertFree(offset + size, freeSize - size);
+    }
+
+    this->used += size;
+    return Range{offset, size};
+}
+
+void RangeAllocator::free(Range range) {
+    if (range.size == 0) {
+        return;
+    }
+    if (static_cast<uint64_t>(range.offset) + range.size > this->capacity) {
+        throw std::out_of_range(std::format("Freeing [{}, {}) past the capacity of {}", range.offset, range.offset + range.size, this->capacity));
+    }
+
+    uint32_t offset = range.offset;
+    uint32_t size = range.size;
+
+    auto next = this->freeByOffset.lower_bound(offset);
+    if (next != this->freeByOffset.end() && next->first < offset + size) {
+        throw std::runtime_error(std::format("Freeing [{}, {}) which is already free", range.offset, range.offset + range.size));
+    }
+    if (next != this->freeByOffset.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second > offset) {
+            throw std::runtime_error(std::format("Freeing [{}, {}) which is already free", range.offset, range.offset + range.size));
+        }
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            this->eraseFree(prev);
+        }
+    }
+    if (next != this->freeByOffset.end() && next->first == range.offset + range.size) {
+        size += next->second;
+        this->eraseFree(next);
+    }
+
+    this->insertFree(offset, size);
+    this->used -= range.size;
+}
+
+void RangeAllocator::reset(uint32_t capacity) {
+    this->capacity = capacity;
+    this->used = 0;
+    this->freeByOffset.clear();
+    this->freeBySize.clear();
+    if (capacity > 0) {
+        this->insertFree(0, capacity);
+    }
+}
+
+uint32_t RangeAllocator::getCapacity() const {
+    return this->capacity;
+}
+
+uint32_t RangeAllocator::getUsed() const {
+    return this->used;
+}
+
+uint32_t RangeAllocator::getFree() const {
+    return this->capacity - this->used;
+}
+
+size_t RangeAllocator::getFreeRangeCount() const {
+    return this->freeByOffset.size();
+}
+
+uint32_t RangeAllocator::getLargestFreeRange() const {
+    return this->freeBySize.empty() ? 0 : this->freeBySize.rbegin()->first;
+}
+
+double RangeAllocator::getFragmentation() const {
+    uint32_t free = this->getFree();
+    if (free == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(this->getLargestFreeRange()) / free;
+}
+
+void RangeAllocator::insertFree(uint32_t offset, uint32_t size) {
+    this->freeByOffset.emplace(offset, size);
+    this->freeBySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFree(std::map<uint32_t, uint32_t>::iterator it) {
+    this->freeBySize.erase({it->second, it->first});
+    this->freeByOffset.erase(it);
+}
@@ -0,0 +1,50 @@
+#ifndef RANGE_ALLOCATOR_H
+#define RANGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+/** 
+ * Hands out ranges of [0, capacity) in whatever unit the caller uses (vertices, indices, bytes), doesnt own any memory.
+ * Best fit through a size ordered index of the free ranges, freeing merges with the neighbours so the free list 
+ * only splinters as far as the live ranges force it to
+ * */
+class RangeAllocator {
+    public:
+        struct Range {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        explicit RangeAllocator(uint32_t capacity);
+
+        //nullopt if no single free range is big enough, even if the total free space is
+        std::optional<Range> allocate(uint32_t size);
+        //range doesnt have to be one that allocate returned, just something thats in use
+        void free(Range range);
+        //everything free again
+        void reset(uint32_t capacity);
+
+        uint32_t getCapacity() const;
+        uint32_t getUsed() const;
+        uint32_t getFree() const;
+        size_t getFreeRangeCount() const;
+        uint32_t getLargestFreeRange() const;
+        //0 while all free space is one range, towards 1 the more its splintered
+        double getFragmentation() const;
+
+    private:
+        uint32_t capacity;
+        uint32_t used;
+        std::map<uint32_t, uint32_t> freeByOffset;
+        std::set<std::pair<uint32_t, uint32_t>> freeBySize;     //(size, offset)
+
+        void insertFree(uint32_t offset, uint32_t size);
+        void eraseFree(std::map<uint32_t, uint32_t>::iterator it);
+};
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef RESOURCE_POOL_H
+#define RESOURCE_POOL_H
+
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Index into a ResourcePool plus the generation of the slot when it was handed out. Once the resource is released
+ * the slot moves on to the next generation, so old copies of the handle stop resolving instead of pointing at whatever reuses the slot.
+ * Generation 0 is never handed out, a default constructed handle is null
+ * */
+template<typename T>
+struct Handle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool isNull() const {
+        return this->generation == 0;
+    }
+
+    bool operator==(const Handle&) const = default;
+};
+
+/**
+ * Owns every T it hands out handles to. Nothing is destroyed when a handle goes away, only release() retires a resource,
+ * and retired ones are destroyed in collect(), which the owner calls at a point where that is safe (GL thread, end of frame).
+ * Not thread safe, only use it from the thread that owns the resources
+ * */
+template<typename T>
+class ResourcePool {
+    public:
+        //name only shows up in error messages
+        ResourcePool(std::string name) : name(std::move(name)), aliveCount(0) {}
+
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        template<typename... Args>
+        Handle<T> create(Args&&... args) {
+            return this->adopt(std::make_unique<T>(std::forward<Args>(args)...));
+        }
+
+        //for resources with non public constructors (or built elsewhere)
+        Handle<T> adopt(std::unique_ptr<T> object) {
+            uint32_t index;
+            if (!this->freeSlots.empty()) {
+                index = this->freeSlots.back();
+                this->freeSlots.pop_back();
+            } else {
+                index = static_cast<uint32_t>(this->slots.size());
+                this->slots.push_back({nullptr, 1, false});
+            }
+
+            Slot &slot = this->slots[index];
+            slot.object = std::move(object);
+            slot.alive = true;
+            this->aliveCount++;
+            return {index, slot.generation};
+        }
+
+        //in debug builds a stale or null handle throws, release builds dont check anything
+        T& get(Handle<T> handle) const {
+#ifndef NDEBUG
+            if (!this->isAlive(handle)) {
+                throw std::runtime_error(this->describeStale(handle));
+            }
+#endif
+            return *this->slots[handle.index].object;
+        }
+
+        //checked in every build, nullptr if the handle is stale
+        T* tryGet(Handle<T> handle) const {
+            return this->isAlive(handle) ? this->slots[handle.index].object.get() : nullptr;
+        }
+
+        bool isAlive(Handle<T> handle) const {
+            return !handle.isNull() && handle.index < this->slots.size() && this->slots[handle.index].generation == handle.generation;
+        }
+
+        //the handle (and all copies of it) stop resolving right away, the resource itself lives until the next collect()
+        void release(Handle<T> handle) {
+            if (!this->isAlive(handle)) {
+#ifndef NDEBUG
+                throw std::runtime_error(this->describeStale(handle));
+#else
+                return;
+#endif
+            }
+
+            Slot &slot = this->slots[handle.index];
+            //skip 0 on wrap around so a null handle never becomes valid
+            slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+            slot.alive = false;
+            this->retired.push_back(handle.index);
+            this->aliveCount--;
+        }
+
+        //destroys everything released since the last call, returns how many
+        size_t collect() {
+            size_t count = this->retired.size();
+            for (uint32_t index : this->retired) {
+                this->slots[index].object.reset();
+                this->freeSlots.push_back(index);
+            }
+            this->retired.clear();
+            return count;
+        }
+
+        //releases and destroys everything, existing handles all go stale
+        void clear() {
+            for (uint32_t index = 0; index < this->slots.size(); index++) {
+                if (this->slots[index].alive) {
+                    this->release({index, this->slots[index].generation});
+                }
+            }
+            this->collect();
+        }
+
+        //visits every live resource in slot order as f(handle, resource), dont create or release from inside f
+        template<typename F>
+        void forEach(F &&f) {
+            for (uint32_t index = 0; index < this->slots.size(); index++) {
+                if (this->slots[index].alive) {
+                    f(Handle<T>{index, this->slots[index].generation}, *this->slots[index].object);
+                }
+            }
+        }
+
+        size_t size() const {
+            return this->aliveCount;
+        }
+
+        size_t getRetiredCount() const {
+            return this->retired.size();
+        }
+
+    private:
+        struct Slot {
+            std::unique_ptr<T> object;
+            uint32_t generation;
+            bool alive;
+        };
+
+        std::string name;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::vector<uint32_t> retired;
+        size_t aliveCount;
+
+        std::string describeStale(Handle<T> handle) const {
+            if (handle.isNull()) {
+                return std::format("Null {} handle", this->name);
+            }
+            if (handle.index >= this->slots.size()) {
+                return std::format("{} handle {} is out of range ({} slots)", this->name, handle.index, this->slots.size());
+            }
+            return std::format("Stale {} handle {} (generation {}, slot is at generation {})",
+                    this->name, handle.index, handle.generation, this->slots[handle.index].generation);
+        }
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "rewind_buffer.h"
+#include "rle.h"
+
+#include <algorithm>
+
+RewindBuffer::RewindBuffer(uint32_t capacityTicks, size_t maxBytes, uint32_t keyframeInterval) : 
+    frames(std::max<uint32_t>(capacityTicks, 2)), head(0), count(0), 
+    keyframeInterval(std::clamp<uint32_t>(keyframeInterval, 1, std::max<uint32_t>(capacityTicks / 2, 1))), 
+    maxBytes(maxBytes), storedBytes(0), keyframeCount(0), sinceKeyframe(0), forceKeyframe(true)
+{
+}
+
+void RewindBuffer::push(uint64_t tick, std::span<const BoardCell> cells, std::span<const std::byte> entities) {
+    auto cellBytes = std::as_bytes(cells);
+    if (this->count > 0 && (tick != this->getNewestTick() + 1 || cellBytes.size() != this->previousCells.size())) {
+        this->clear();
+    }
+    if (this->count == this->frames.size()) {
+        this->evictGroup();
+    }
+
+    bool keyframe = this->forceKeyframe || this->sinceKeyframe >= this->keyframeInterval;
+    bool entitiesRaw = keyframe || entities.size() != this->previousEntities.size();
+
+    //evicted slots gave their buffers back, so this only reuses slots that never held anything
+    Frame &frame = this->at(this->count);
+    frame.tick = tick;
+    frame.keyframe = keyframe;
+    frame.entitiesRaw = entitiesRaw;
+    frame.entityBytes = entities.size();
+    frame.cells.clear();
+    frame.entities.clear();
+    this->encode(cellBytes, this->previousCells, !keyframe, frame.cells);
+    this->encode(entities, this->previousEntities, !entitiesRaw, frame.entities);
+
+    this->count++;
+    this->storedBytes += frame.cells.capacity() + frame.entities.capacity();
+    this->keyframeCount += keyframe;
+    this->sinceKeyframe = keyframe ? 1 : this->sinceKeyframe + 1;
+    this->forceKeyframe = false;
+
+    while (this->storedBytes > this->maxBytes && this->keyframeCount > 1) {
+        this->evictGroup();
+    }
+    //only the current group is left and its still too big, start a new one so it can go next time
+    if (this->storedBytes > this->maxBytes) {
+        this->forceKeyframe = true;
+    }
+}
+
+bool RewindBuffer::seek(uint64_t tick, std::span<BoardCell> cells, std::vector<std::byte> &entities) {
+    auto cellBytes = std::as_writable_bytes(cells);
+    if (this->count == 0 || tick < this->getOldestTick() || tick > this->getNewestTick() || cellBytes.size() != this->previousCells.size()) {
+        return false;
+    }
+
+    size_t target = tick - this->getOldestTick();
+    size_t keyframe = target;
+    while (!this->at(keyframe).keyframe) {
+        keyframe--;
+    }
+
+    for (size_t offset = keyframe; offset <= target; offset++) {
+        const Frame &frame = this->at(offset);
+        if (!this->decode(frame.cells, cellBytes, !frame.keyframe)) {
+            return false;
+        }
+
+        if (frame.entitiesRaw) {
+            entities.resize(frame.entityBytes);
+        }
+        if (!this->decode(frame.entities, entities, !frame.entitiesRaw)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RewindBuffer::clear() {
+    for (Frame &frame : this->frames) {
+        this->release(frame);
+    }
+    this->head = 0;
+    this->count = 0;
+    this->storedBytes = 0;
+    this->keyframeCount = 0;
+    this->sinceKeyframe = 0;
+    this->forceKeyframe = true;
+}
+
+bool RewindBuffer::empty() const {
+    return this->count == 0;
+}
+
+uint64_t RewindBuffer::getOldestTick() const {
+    return this->frames[this->head].tick;
+}
+
+uint64_t RewindBuffer::getNewestTick() const {
+    return this->frames[(this->head + this->count - 1) % this->frames.size()].tick;
+}
+
+size_t RewindBuffer::getFrameCount() const {
+    return this->count;
+}
+
+size_t RewindBuffer::getStoredBytes() const {
+    return this->storedBytes;
+}
+
+RewindBuffer::Frame& RewindBuffer::at(size_t offset) {
+    return this->frames[(this->head + offset) % this->frames.size()];
+}
+
+void RewindBuffer::evictGroup() {
+    //a keyframe and the deltas hanging off it go together
+    do {
+        Frame &frame = this->at(0);
+        this->storedBytes -= frame.cells.capacity() + frame.entities.capacity();
+        this->keyframeCount -= frame.keyframe;
+        this->release(frame);
+        this->head = (this->head + 1) % this->frames.size();
+        this->count--;
+    } while (this->count > 0 && !this->at(0).keyframe);
+
+    if (this->count == 0) {
+        this->clear();
+    }
+}
+
+void RewindBuffer::release(Frame &frame) {
+    //a slot that held a keyframe would otherwise keep that much memory around as a small delta
+    std::vector<std::byte>().swap(frame.cells);
+    std::vector<std::byte>().swap(frame.entities);
+}
+
+void RewindBuffer::encode(std::span<const std::byte> current, std::vector<std::byte> &previous, bool delta, std::vector<std::byte> &out) {
+    //a keyframe is just the delta against an empty state, mostly empty boards stay small and dense ones dont pay for a real compressor
+    if (!delta) {
+        previous.assign(current.size(), std::byte{0});
+    }
+    Rle::compressXor(current, previous, out);
+}
+
+bool RewindBuffer::decode(const std::vector<std::byte> &in, std::span<std::byte> state, bool delta) {
+    if (!delta) {
+        std::fill(state.begin(), state.end(), std::byte{0});
+    }
+    return Rle::applyXor(in, state);
+}
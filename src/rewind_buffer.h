@@ -0,0 +1,59 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "board_file.h"
+
+/** 
+ * Ring of the last capacityTicks ticks of board + entity state. Every tick stores a sparse xor delta (Rle::compressXor) 
+ * against the previous tick, every keyframeInterval ticks against an empty state instead so seeking only has to 
+ * replay from the nearest keyframe.
+ * Oldest keyframe groups are dropped once the memory held by the encoded frames goes over maxBytes.
+ * */
+class RewindBuffer {
+    public:
+        RewindBuffer(uint32_t capacityTicks, size_t maxBytes, uint32_t keyframeInterval = 60);
+
+        /** ticks have to be pushed in order without gaps, a gap or a board resize starts over */
+        void push(uint64_t tick, std::span<const BoardCell> cells, std::span<const std::byte> entities);
+        /** restores the state of tick, cells has to be the same size as pushed. false if the tick isnt held anymore */
+        bool seek(uint64_t tick, std::span<BoardCell> cells, std::vector<std::byte> &entities);
+        void clear();
+
+        bool empty() const;
+        uint64_t getOldestTick() const;
+        uint64_t getNewestTick() const;
+        size_t getFrameCount() const;
+        size_t getStoredBytes() const;
+
+    private:
+        struct Frame {
+            uint64_t tick;
+            bool keyframe;
+            bool entitiesRaw;       //entities changed size, so stored whole instead of as a delta
+            size_t entityBytes;
+            std::vector<std::byte> cells;
+            std::vector<std::byte> entities;
+        };
+
+        std::vector<Frame> frames;
+        size_t head, count;
+        uint32_t keyframeInterval;
+        size_t maxBytes, storedBytes;
+        size_t keyframeCount;
+        uint32_t sinceKeyframe;
+        bool forceKeyframe;
+
+        std::vector<std::byte> previousCells, previousEntities;
+
+        Frame& at(size_t offset);
+        void evictGroup();
+        void release(Frame &frame);
+        void encode(std::span<const std::byte> current, std::vector<std::byte> &previous, bool delta, std::vector<std::byte> &out);
+        bool decode(const std::vector<std::byte> &in, std::span<std::byte> state, bool delta);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "rle.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    //short changed gaps are cheaper to keep in the literal than to start a new span
+    constexpr size_t MIN_UNCHANGED = 8;
+
+    void writeVarint(size_t value, std::vector<std::byte> &out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::byte>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::byte>(value));
+    }
+
+    bool readVarint(std::span<const std::byte> in, size_t &i, size_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (i >= in.size()) {
+                return false;
+            }
+            size_t byte = static_cast<size_t>(in[i++]);
+            value |= (byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void Rle::compress(std::span<const std::byte> in, std::vector<std::byte> &out) {
+    size_t i = 0;
+    while (i < in.size()) {
+        //run of at least 2
+        size_t run = 1;
+        while (i + run < in.size() && run < 129 && in[i + run] == in[i]) {
+            run++;
+        }
+        if (run >= 2) {
+            out.push_back(static_cast<std::byte>(run + 126));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        //literals until the next run of 3 (a run of 2 isnt worth breaking the literal for)
+        size_t start = i;
+        while (i < in.size() && i - start < 128) {
+            if (i + 2 < in.size() && in[i] == in[i + 1] && in[i] == in[i + 2]) {
+                break;
+            }
+            i++;
+        }
+        out.push_back(static_cast<std::byte>(i - start - 1));
+        out.insert(out.end(), in.begin() + start, in.begin() + i);
+    }
+}
+
+bool Rle::decompress(std::span<const std::byte> in, std::vector<std::byte> &out) {
+    size_t i = 0;
+    while (i < in.size()) {
+        size_t control = static_cast<size_t>(in[i++]);
+        if (control < 128) {
+            size_t count = control + 1;
+            if (i + count > in.size()) {
+                return false;
+            }
+            out.insert(out.end(), in.begin() + i, in.begin() + i + count);
+            i += count;
+        } else {
+            if (i >= in.size()) {
+                return false;
+            }
+            out.insert(out.end(), control - 126, in[i++]);
+        }
+    }
+    return true;
+}
+
+bool Rle::decompressInto(std::span<const std::byte> in, std::span<std::byte> out) {
+    size_t i = 0, o = 0;
+    while (i < in.size()) {
+        size_t control = static_cast<size_t>(in[i++]);
+        if (control < 128) {
+            size_t count = control + 1;
+            if (i + count > in.size() || o + count > out.size()) {
+                return false;
+            }
+            std::memcpy(out.data() + o, in.data() + i, count);
+            i += count, o += count;
+        } else {
+            size_t count = control - 126;
+            if (i >= in.size() || o + count > out.size()) {
+                return false;
+            }
+            std::memset(out.data() + o, static_cast<int>(in[i++]), count);
+            o += count;
+        }
+    }
+    return o == out.size();
+}
+
+void Rle::compressXor(std::span<const std::byte> current, std::span<std::byte> previous, std::vector<std::byte> &out) {
+    const std::byte *cur = current.data();
+    std::byte *prev = previous.data();
+    size_t size = current.size(), i = 0;
+    while (i < size) {
+        size_t start = i;
+        while (i + sizeof(uint64_t) <= size) {
+            uint64_t a, b;
+            std::memcpy(&a, cur + i, sizeof(a));
+            std::memcpy(&b, prev + i, sizeof(b));
+            if (a != b) {
+                break;
+            }
+            i += sizeof(uint64_t);
+        }
+        while (i < size && cur[i] == prev[i]) {
+            i++;
+        }
+        if (i == size) {
+            break;      //trailing unchanged bytes are implied
+        }
+
+        size_t changed = i, unchanged = 0;
+        while (i < size && unchanged < MIN_UNCHANGED) {
+            unchanged = cur[i] == prev[i] ? unchanged + 1 : 0;
+            i++;
+        }
+        i -= unchanged;
+
+        writeVarint(changed - start, out);
+        writeVarint(i - changed, out);
+        size_t at = out.size();
+        out.resize(at + i - changed);
+        for (size_t j = changed; j < i; j++) {
+            out[at++] = cur[j] ^ prev[j];
+            prev[j] = cur[j];
+        }
+    }
+}
+
+bool Rle::applyXor(std::span<const std::byte> in, std::span<std::byte> state) {
+    size_t i = 0, o = 0;
+    while (i < in.size()) {
+        size_t skip, count;
+        if (!readVarint(in, i, skip) || !readVarint(in, i, count)) {
+            return false;
+        }
+        o += skip;
+        if (o + count > state.size() || i + count > in.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < count; j++) {
+            state[o + j] ^= in[i + j];
+        }
+        i += count, o += count;
+    }
+    return true;
+}
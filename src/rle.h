@@ -0,0 +1,31 @@
+#ifndef RLE_H
+#define RLE_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/** 
+ * PackBits style byte RLE. Control byte n < 128: n + 1 literal bytes follow, n >= 128: the next byte repeats n - 126 times.
+ * Worst case grows the input by 1/128, runs of zeros (xor deltas) shrink ~64x
+ * */
+class Rle {
+    public:
+        //appends to out
+        static void compress(std::span<const std::byte> in, std::vector<std::byte> &out);
+        //appends to out, returns false if in is malformed
+        static bool decompress(std::span<const std::byte> in, std::vector<std::byte> &out);
+        //decompresses into exactly out.size() bytes, returns false if in is malformed or the sizes dont match
+        static bool decompressInto(std::span<const std::byte> in, std::span<std::byte> out);
+
+        /** 
+         * Sparse xor delta of two same sized buffers: [varint unchanged bytes][varint changed bytes][changed bytes ^ previous]...
+         * Unchanged spans are found a word at a time and applying only touches the changed bytes.
+         * previous is updated to current as it goes, appends to out
+         * */
+        static void compressXor(std::span<const std::byte> current, std::span<std::byte> previous, std::vector<std::byte> &out);
+        //xors a compressXor delta into state, works both ways. returns false if in is malformed
+        static bool applyXor(std::span<const std::byte> in, std::span<std::byte> state);
+};
+
+#endif
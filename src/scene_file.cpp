@@ -0,0 +1,173 @@
+#include "scene_file.h"
+#include "vertex_quantize.h"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SceneFormat;
+
+SceneFile::SceneFile(const std::filesystem::path &path) : 
+    data(nullptr), size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("File: {} failed to open: {}", path.string(), std::strerror(errno)));
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error(std::format("File: {} is not a scene file", path.string()));
+    }
+    this->size = info.st_size;
+
+    void *mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error(std::format("Failed to map {}: {}", path.string(), std::strerror(errno)));
+    }
+    this->data = static_cast<const std::byte*>(mapping);
+
+    //validate everything up front so get() can hand out spans without checks
+    auto header = reinterpret_cast<const FileHeader*>(this->data);
+    uint64_t tableEnd = sizeof(FileHeader) + static_cast<uint64_t>(header->sectionCount) * sizeof(SectionEntry);
+    std::string error;
+    if (header->magic != MAGIC) {
+        error = "bad magic";
+    } else if (header->version != VERSION) {
+        error = std::format("unsupported version {}", header->version);
+    } else if (header->fileSize != this->size || tableEnd > this->size) {
+        error = "truncated";
+    }
+
+    if (error.empty()) {
+        this->sections = {reinterpret_cast<const SectionEntry*>(this->data + sizeof(FileHeader)), header->sectionCount};
+        for (const auto &entry : this->sections) {
+            if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset < tableEnd || entry.offset > this->size || 
+                    entry.size > this->size - entry.offset || entry.elementSize == 0 || 
+                    //divide first, count * elementSize could wrap around and match a small size
+                    entry.count > entry.size / entry.elementSize || entry.size != entry.count * entry.elementSize) {
+                error = std::format("bad section entry (type {})", static_cast<uint32_t>(entry.type));
+                break;
+            }
+        }
+    }
+
+    if (!error.empty()) {
+        munmap(const_cast<std::byte*>(this->data), this->size);
+        throw std::runtime_error(std::format("Scene file {} is invalid: {}", path.string(), error));
+    }
+}
+
+SceneFile::~SceneFile() {
+    munmap(const_cast<std::byte*>(this->data), this->size);
+}
+
+bool SceneFile::hasSection(SectionType type) const {
+    return this->find(type) != nullptr;
+}
+
+VaoHandle SceneFile::createVao(GLResources &resources) const {
+    auto vertexEntry = this->find(SectionType::Vertices);
+    if (!vertexEntry) {
+        vertexEntry = this->find(SectionType::HalfVertices);
+    }
+    if (!vertexEntry) {
+        vertexEntry = this->find(SectionType::Snorm16Vertices);
+    }
+    auto indexEntry = this->find(SectionType::Indices);
+    if (!vertexEntry || !indexEntry) {
+        throw std::runtime_error("Scene file has no mesh");
+    }
+
+    //uploads read front to back, let the kernel read ahead instead of faulting page by page
+    this->adviseSequential(*vertexEntry);
+    this->adviseSequential(*indexEntry);
+
+    auto bounds = this->get<DamageRect>(SectionType::Bounds);
+    auto knownBounds = bounds.empty() ? std::nullopt : std::optional<DamageRect>(bounds[0]);
+    auto indices = this->get<unsigned int>(SectionType::Indices);
+    switch (vertexEntry->type) {
+        case SectionType::HalfVertices:
+            return resources.getVaos().create(this->get<HalfPositionVertex>(SectionType::HalfVertices), indices, knownBounds);
+        case SectionType::Snorm16Vertices:
+            return resources.getVaos().create(this->get<Snorm16PositionVertex>(SectionType::Snorm16Vertices), indices, knownBounds);
+        default:
+            return resources.getVaos().create(this->get<float>(SectionType::Vertices), indices, knownBounds);
+    }
+}
+
+const SectionEntry* SceneFile::find(SectionType type) const {
+    for (const auto &entry : this->sections) {
+        if (entry.type == type) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void SceneFile::checkElementSize(const SectionEntry &entry, size_t elementSize) const {
+    //vertices are stored per float, so 4 byte elements, not per vertex
+    if (entry.elementSize != elementSize) {
+        throw std::runtime_error(std::format("Scene section {} has {} byte elements, expected {}", 
+                static_cast<uint32_t>(entry.type), entry.elementSize, elementSize));
+    }
+}
+
+void SceneFile::adviseSequential(const SectionEntry &entry) const {
+    //offsets are page aligned, so this is a valid madvise range
+    madvise(const_cast<std::byte*>(this->data + entry.offset), entry.size, MADV_SEQUENTIAL);
+    madvise(const_cast<std::byte*>(this->data + entry.offset), entry.size, MADV_WILLNEED);
+}
+
+void SceneWriter::addSection(SectionType type, uint32_t elementSize, const void *data, uint64_t count) {
+    this->sections.push_back({type, elementSize, std::span<const std::byte>(static_cast<const std::byte*>(data), elementSize * count), count});
+}
+
+void SceneWriter::write(const std::filesystem::path &path) const {
+    auto align = [](uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    };
+
+    std::vector<SectionEntry> entries;
+    uint64_t offset = align(sizeof(FileHeader) + this->sections.size() * sizeof(SectionEntry));
+    for (const auto &section : this->sections) {
+        entries.push_back({section.type, section.elementSize, offset, section.bytes.size(), section.count});
+        offset = align(offset + section.bytes.size());
+    }
+
+    //the last blob doesnt need padding after it
+    uint64_t fileSize = entries.empty() ? sizeof(FileHeader) : entries.back().offset + entries.back().size;
+    FileHeader header{MAGIC, VERSION, static_cast<uint32_t>(entries.size()), 0, fileSize};
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::format("File: {} failed to open", tmpPath.string()));
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SectionEntry));
+        for (size_t i = 0; i < entries.size(); i++) {
+            //zero fill up to the aligned start
+            std::vector<char> padding(entries[i].offset - static_cast<uint64_t>(file.tellp()), 0);
+            file.write(padding.data(), padding.size());
+            file.write(reinterpret_cast<const char*>(this->sections[i].bytes.data()), this->sections[i].bytes.size());
+        }
+
+        if (!file) {
+            throw std::runtime_error(std::format("Failed to write {}", tmpPath.string()));
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
@@ -0,0 +1,117 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include "gl_resources.h"
+
+/** 
+ * Binary scene container, laid out so it can be mmaped and handed to GL as is:
+ *   FileHeader | SectionEntry[sectionCount] | padding | blob | padding | blob ...
+ * Every blob starts on a SECTION_ALIGNMENT boundary. All values are little endian, native layout
+ * */
+namespace SceneFormat {
+    constexpr uint32_t MAGIC = 0x53544c47;     //"GLTS"
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t SECTION_ALIGNMENT = 4096;
+
+    enum class SectionType : uint32_t {
+        Vertices = 1,       //float xyz
+        Indices = 2,        //uint32 triangles
+        Instances = 3,      //SceneInstance
+        Bounds = 4,         //one DamageRect over all vertices, so loading doesnt have to walk them
+        HalfVertices = 5,   //HalfPositionVertex, instead of Vertices
+        Snorm16Vertices = 6 //Snorm16PositionVertex, instead of Vertices
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t sectionCount;
+        uint32_t reserved;
+        uint64_t fileSize;
+    };
+
+    struct SectionEntry {
+        SectionType type;
+        uint32_t elementSize;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t count;
+    };
+
+    struct SceneInstance {
+        float x, y, z;
+        float r, g, b;
+    };
+}
+
+class SceneFile {
+    public:
+        //maps the file and validates the section table, nothing else gets touched until used
+        SceneFile(const std::filesystem::path &path);
+        ~SceneFile();
+
+        SceneFile(const SceneFile&) = delete;
+        SceneFile& operator=(const SceneFile&) = delete;
+
+        bool hasSection(SceneFormat::SectionType type) const;
+
+        //empty span if the section is missing, throws if its element size doesnt match T
+        template<typename T>
+        std::span<const T> get(SceneFormat::SectionType type) const {
+            auto entry = this->find(type);
+            if (!entry) {
+                return {};
+            }
+            this->checkElementSize(*entry, sizeof(T));
+            return {reinterpret_cast<const T*>(this->data + entry->offset), static_cast<size_t>(entry->count)};
+        }
+
+        /** 
+         * Uploads the vertex and index sections straight out of the mapping, no intermediate copies
+         * (except for indices that fit 16 bits, VaoWrapper narrows those).
+         * Takes whichever vertex section the file has. Needs a current context
+         * */
+        VaoHandle createVao(GLResources &resources) const;
+
+    private:
+        const std::byte *data;
+        size_t size;
+        std::span<const SceneFormat::SectionEntry> sections;
+
+        const SceneFormat::SectionEntry* find(SceneFormat::SectionType type) const;
+        void checkElementSize(const SceneFormat::SectionEntry &entry, size_t elementSize) const;
+        void adviseSequential(const SceneFormat::SectionEntry &entry) const;
+};
+
+class SceneWriter {
+    public:
+        //data isnt copied, it has to stay alive until write()
+        void addSection(SceneFormat::SectionType type, uint32_t elementSize, const void *data, uint64_t count);
+
+        template<typename T>
+        void addSection(SceneFormat::SectionType type, std::span<const T> data) {
+            this->addSection(type, sizeof(T), data.data(), data.size());
+        }
+
+        //writes to a temp file next to path and renames it over, throws on failure
+        void write(const std::filesystem::path &path) const;
+
+    private:
+        struct PendingSection {
+            SceneFormat::SectionType type;
+            uint32_t elementSize;
+            std::span<const std::byte> bytes;
+            uint64_t count;
+        };
+
+        std::vector<PendingSection> sections;
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include "gl_deletion_queue.h"
+#include <chrono>
 #include <format>
 #include <fstream>
 #include <shader.h>
@@ -5,6 +7,7 @@
 #include <stdexcept>
 #include <string>
 #include <cassert>
+#include <utility>
 
 extern "C" {
 #include <glad/glad.h>
@@ -12,25 +15,53 @@ extern "C" {
 #include <GL/gl.h>
 }
 
-Shader::Shader(const std::string &vertPath, const std::string &fragPath) {
+Shader::Shader(const ShaderSource &source, std::shared_ptr<ShaderCache> cache) {
+    this->build(source.vert, source.frag, cache);
+}
+
+Shader::Shader(const std::string &vertPath, const std::string &fragPath, std::shared_ptr<ShaderCache> cache) {
     std::string vertCode = this->loadShaderFileFromDisk(vertPath);
     std::string fragCode = this->loadShaderFileFromDisk(fragPath);
 
-    int vertShaderId = this->compileShader(GL_VERTEX_SHADER, std::move(vertCode));
-    int fragShaderId = this->compileShader(GL_FRAGMENT_SHADER, std::move(fragCode));
+    this->build(vertCode, fragCode, cache);
+}
+
+Shader::Shader(unsigned int program, bool loadedFromCache, double buildTimeMs) : 
+    shaderProgram(program), loadedFromCache(loadedFromCache), buildTimeMs(buildTimeMs)
+{
+}
+
+void Shader::build(std::string_view vertCode, std::string_view fragCode, std::shared_ptr<ShaderCache> cache) {
+    auto start = std::chrono::steady_clock::now();
+    this->loadedFromCache = false;
 
-    //TODO: this needs error handling
-    this->shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertShaderId);
-    glAttachShader(shaderProgram, fragShaderId);
-    glLinkProgram(shaderProgram);
+    bool useCache = cache && cache->isSupported();
+    uint64_t key = 0;
+    if (useCache) {
+        key = cache->makeKey(vertCode, fragCode);
 
-    glDeleteShader(vertShaderId);
-    glDeleteShader(fragShaderId);
+        this->shaderProgram = glCreateProgram();
+        this->loadedFromCache = cache->load(key, this->shaderProgram);
+        if (!this->loadedFromCache) {
+            glDeleteProgram(this->shaderProgram);
+        }
+    }
+
+    if (!this->loadedFromCache) {
+        this->shaderProgram = this->linkProgram(vertCode, fragCode, useCache);
+        if (useCache) {
+            cache->store(key, this->shaderProgram);
+        }
+    }
+
+    this->buildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (cache) {
+        cache->recordBuild(this->loadedFromCache, this->buildTimeMs);
+    }
 }
 
 Shader::~Shader() {
-    glDeleteProgram(this->shaderProgram);
+    GLDeletionQueue::global().deleteProgram(this->shaderProgram);
 }
 
 
@@ -47,38 +78,101 @@ std::string Shader::loadShaderFileFromDisk(const std::string &path) {
     return std::move(fileBuff.str());
 }
 
-unsigned int Shader::compileShader(int shaderType, std::string shaderSource)
+unsigned int Shader::linkProgram(std::string_view vertCode, std::string_view fragCode, bool retrievable) {
+    int vertShaderId = this->compileShader(GL_VERTEX_SHADER, vertCode);
+    int fragShaderId = this->compileShader(GL_FRAGMENT_SHADER, fragCode);
+
+    unsigned int program = glCreateProgram();
+    if (retrievable) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(program, vertShaderId);
+    glAttachShader(program, fragShaderId);
+    glLinkProgram(program);
+
+    glDeleteShader(vertShaderId);
+    glDeleteShader(fragShaderId);
+
+    int  success;
+    char infoLog[512];
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        glDeleteProgram(program);
+        throw std::runtime_error(std::format("Failed to link shader program: {}", infoLog));
+    }
+    return program;
+}
+
+unsigned int Shader::compileShader(int shaderType, std::string_view shaderSource)
 {
-    const char* shaderSourceC = shaderSource.c_str();
+    const char* shaderSourceC = shaderSource.data();
+    int shaderSourceLength = static_cast<int>(shaderSource.size());
 
     int id = glCreateShader(shaderType);
-    glShaderSource(id, 1, &shaderSourceC, NULL);
+    glShaderSource(id, 1, &shaderSourceC, &shaderSourceLength);
     glCompileShader(id);
 
     int  success;
     char infoLog[512];
     glGetShaderiv(id, GL_COMPILE_STATUS, &success);
     if (!success) {
-        glGetShaderInfoLog(shaderProgram, 512, NULL, infoLog);
+        glGetShaderInfoLog(id, 512, NULL, infoLog);
+        glDeleteShader(id);
         throw std::runtime_error(std::format("Failed to compile shader: {}", infoLog));
     }
     return id;
 }
 
+bool Shader::wasLoadedFromCache() const {
+    return this->loadedFromCache;
+}
+
+double Shader::getBuildTimeMs() const {
+    return this->buildTimeMs;
+}
+
+void Shader::swapProgram(Shader &other) {
+    std::swap(this->shaderProgram, other.shaderProgram);
+    std::swap(this->uniformLocations, other.uniformLocations);
+    std::swap(this->loadedFromCache, other.loadedFromCache);
+    std::swap(this->buildTimeMs, other.buildTimeMs);
+}
+
 void Shader::bind() {
     glUseProgram(this->shaderProgram);     
 }
 
-void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(this->shaderProgram, name.c_str()), static_cast<int>(value));
+void Shader::setBool(std::string_view name, bool value) const {
+    glUniform1i(this->getUniformLocation(name), static_cast<int>(value));
 }
-void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(this->shaderProgram, name.c_str()), value);
+void Shader::setInt(std::string_view name, int value) const {
+    glUniform1i(this->getUniformLocation(name), value);
 }
-void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(this->shaderProgram, name.c_str()), value);
+void Shader::setFloat(std::string_view name, float value) const {
+    glUniform1f(this->getUniformLocation(name), value);
 }
-void Shader::set3f(const std::string &name, std::array<float, 3> &value) const {
-    glUniform3f(glGetUniformLocation(this->shaderProgram, name.c_str()), value[0], value[1], value[2]);
+void Shader::set3f(std::string_view name, const std::array<float, 3> &value) const {
+    glUniform3f(this->getUniformLocation(name), value[0], value[1], value[2]);
+}
+
+int Shader::getUniformLocation(std::string_view name) const {
+    //a handful of uniforms per shader, a linear scan beats hashing
+    for (const auto &[cachedName, location] : this->uniformLocations) {
+        if (cachedName == name) {
+            return location;
+        }
+    }
+
+    std::string key(name);
+    int location = glGetUniformLocation(this->shaderProgram, key.c_str());
+    this->uniformLocations.emplace_back(std::move(key), location);
+    return location;
+}
+void Shader::bindUniformBlock(const std::string &name, unsigned int binding) const {
+    unsigned int index = glGetUniformBlockIndex(this->shaderProgram, name.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(this->shaderProgram, index, binding);
+    }
 }
 
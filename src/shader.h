@@ -1,22 +1,61 @@
 #ifndef SHADER_H
 #define SHADER_H
+#include <array>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "shader_cache.h"
+
+//sources are only viewed, they have to outlive the Shader constructor (embedded shaders live forever)
+struct ShaderSource {
+    std::string_view vert;
+    std::string_view frag;
+};
+
 class Shader {
     private:
         unsigned int shaderProgram;
+        bool loadedFromCache;
+        double buildTimeMs;
+
+        //name -> location, filled on first use so the setters dont look up (or allocate) every frame
+        mutable std::vector<std::pair<std::string, int>> uniformLocations;
+        int getUniformLocation(std::string_view name) const;
 
         std::string loadShaderFileFromDisk(const std::string &path);
-        unsigned int compileShader(int shaderType, std::string shaderSource);
+        void build(std::string_view vertCode, std::string_view fragCode, std::shared_ptr<ShaderCache> cache);
+        unsigned int compileShader(int shaderType, std::string_view shaderSource);
+        unsigned int linkProgram(std::string_view vertCode, std::string_view fragCode, bool retrievable);
+
+        //adopts an already linked program, used by the async compiler
+        friend class PendingShader;
+        friend class ShaderCompiler;
+        Shader(unsigned int program, bool loadedFromCache, double buildTimeMs);
     public:
-        Shader(const std::string &vertPath, const std::string &fragPath);
+        /** 
+         * If a cache is passed the linked binary is looked up there first, and stored after compiling on a miss
+         * */
+        Shader(const ShaderSource &source, std::shared_ptr<ShaderCache> cache = nullptr);
+        //reads the sources from disk, mostly useful for shaders that arent embedded
+        Shader(const std::string &vertPath, const std::string &fragPath, std::shared_ptr<ShaderCache> cache = nullptr);
         ~Shader();
 
         void bind();
 
-        void setBool(const std::string &name, bool value) const;  
-        void setInt(const std::string &name, int value) const;   
-        void setFloat(const std::string &name, float value) const;
-        void set3f(const std::string &name, std::array<float, 3> &value) const;
+        //exchanges programs with other, used to hot swap a rebuilt program into a shader thats already in use
+        void swapProgram(Shader &other);
+
+        bool wasLoadedFromCache() const;
+        double getBuildTimeMs() const;
+
+        void setBool(std::string_view name, bool value) const;  
+        void setInt(std::string_view name, int value) const;   
+        void setFloat(std::string_view name, float value) const;
+        void set3f(std::string_view name, const std::array<float, 3> &value) const;
+        //does nothing if the program doesnt use the block
+        void bindUniformBlock(const std::string &name, unsigned int binding) const;
 };
 
 #endif
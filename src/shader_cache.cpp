@@ -0,0 +1,187 @@
+#include "shader_cache.h"
+#include "gl_extensions.h"
+
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+namespace {
+    //FNV-1a, plenty for cache keys
+    uint64_t hashBytes(uint64_t hash, std::string_view data) {
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+        //separator so ("ab", "c") and ("a", "bc") dont collide
+        hash ^= 0xff;
+        hash *= 0x100000001b3ull;
+        return hash;
+    }
+
+    std::string glString(GLenum name) {
+        auto str = reinterpret_cast<const char*>(glGetString(name));
+        return str ? str : "";
+    }
+}
+
+ShaderCache::ShaderCache(std::filesystem::path directory) : 
+    directory(std::move(directory)), supported(-1), stats{0, 0, 0, 0}
+{
+}
+
+std::filesystem::path ShaderCache::defaultDirectory() {
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return std::filesystem::path(xdg) / "gltemplate" / "shaders";
+    }
+    if (const char *home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "gltemplate" / "shaders";
+    }
+    return std::filesystem::path("shader_cache");
+}
+
+bool ShaderCache::isSupported() {
+    if (this->supported != -1) {
+        return this->supported;
+    }
+
+    this->supported = 0;
+    if (GLAD_GL_VERSION_4_1 || GLExtensions::has("GL_ARB_get_program_binary")) {
+        GLExtensions::loadIfMissing(glad_glGetProgramBinary, "glGetProgramBinary");
+        GLExtensions::loadIfMissing(glad_glProgramBinary, "glProgramBinary");
+        GLExtensions::loadIfMissing(glad_glProgramParameteri, "glProgramParameteri");
+
+        int formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+        //some drivers expose the extension but no formats, which means no binaries will ever come back.
+        //the entry points themselves arent checked, with the lazy loader theyre never null
+        this->supported = formats > 0;
+    }
+
+    if (this->supported) {
+        this->driverId = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+        std::error_code err;
+        std::filesystem::create_directories(this->directory, err);
+        if (err) {
+            this->supported = 0;
+        }
+    }
+    return this->supported;
+}
+
+uint64_t ShaderCache::makeKey(std::string_view vertSource, std::string_view fragSource, std::string_view defines) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hashBytes(hash, this->driverId);
+    hash = hashBytes(hash, defines);
+    hash = hashBytes(hash, vertSource);
+    hash = hashBytes(hash, fragSource);
+    return hash;
+}
+
+bool ShaderCache::load(uint64_t key, unsigned int program) {
+    auto path = this->entryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    FileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    //the length comes off disk, it has to account for exactly the rest of the file before anything gets allocated for it
+    std::error_code sizeErr;
+    uint64_t fileSize = std::filesystem::file_size(path, sizeErr);
+
+    std::vector<char> binary;
+    bool valid = file && !sizeErr && header.magic == MAGIC && header.version == FORMAT_VERSION && header.key == key && 
+            fileSize >= sizeof(header) && header.binaryLength == fileSize - sizeof(header);
+    if (valid) {
+        binary.resize(header.binaryLength);
+        file.read(binary.data(), binary.size());
+        valid = static_cast<bool>(file);
+    }
+    file.close();
+
+    if (valid) {
+        glProgramBinary(program, header.binaryFormat, binary.data(), binary.size());
+
+        int success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        valid = success;
+    }
+
+    //truncated, corrupt, from an older format, or the driver doesnt like it anymore
+    if (!valid) {
+        std::error_code err;
+        std::filesystem::remove(path, err);
+    }
+    return valid;
+}
+
+void ShaderCache::store(uint64_t key, unsigned int program) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+
+    FileHeader header{MAGIC, FORMAT_VERSION, key, binaryFormat, static_cast<uint32_t>(length)};
+
+    //write to a temp file and rename over, so a crash or another instance never sees half an entry
+    auto path = this->entryPath(key);
+    auto tmpPath = path;
+    tmpPath += std::format(".{}.tmp", getpid());
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            file.close();
+            std::error_code err;
+            std::filesystem::remove(tmpPath, err);
+            return;
+        }
+    }
+
+    std::error_code err;
+    std::filesystem::rename(tmpPath, path, err);
+    if (err) {
+        std::filesystem::remove(tmpPath, err);
+    }
+}
+
+void ShaderCache::recordBuild(bool hit, double ms) {
+    if (hit) {
+        this->stats.hits++;
+        this->stats.hitMs += ms;
+    } else {
+        this->stats.misses++;
+        this->stats.missMs += ms;
+    }
+}
+
+const ShaderCache::Stats& ShaderCache::getStats() const {
+    return this->stats;
+}
+
+std::filesystem::path ShaderCache::entryPath(uint64_t key) const {
+    return this->directory / std::format("{:016x}.bin", key);
+}
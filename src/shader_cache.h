@@ -0,0 +1,61 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/** 
+ * On disk cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+ * Entries are keyed by a hash of the shader sources, defines and the driver strings, so a driver update 
+ * or a source change just misses and recompiles. Binaries the driver rejects get deleted.
+ * */
+class ShaderCache {
+    public:
+        struct Stats {
+            int hits, misses;
+            double hitMs, missMs;       //total time spent building programs on each path
+        };
+
+        ShaderCache(std::filesystem::path directory);
+
+        //$XDG_CACHE_HOME/gltemplate/shaders, falls back to ~/.cache and then the working dir
+        static std::filesystem::path defaultDirectory();
+
+        //needs a current context, false if the driver cant give us binaries
+        bool isSupported();
+
+        uint64_t makeKey(std::string_view vertSource, std::string_view fragSource, std::string_view defines = "");
+
+        /** 
+         * Tries to load the binary for key into program (created but not linked).
+         * Returns false on a miss, if it returns true the program is linked and ready to use
+         * */
+        bool load(uint64_t key, unsigned int program);
+        void store(uint64_t key, unsigned int program);
+
+        void recordBuild(bool hit, double ms);
+        const Stats& getStats() const;
+
+    private:
+        static constexpr uint32_t MAGIC = 0x43534c47;       //"GLSC"
+        static constexpr uint32_t FORMAT_VERSION = 1;
+
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t key;
+            uint32_t binaryFormat;
+            uint32_t binaryLength;
+        };
+
+        std::filesystem::path directory;
+        int supported;          //-1 until first checked
+        std::string driverId;
+        Stats stats;
+
+        std::filesystem::path entryPath(uint64_t key) const;
+};
+
+#endif
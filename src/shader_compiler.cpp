@@ -0,0 +1,191 @@
+#include "shader_compiler.h"
+#include "gl_extensions.h"
+#include "gl_deletion_queue.h"
+
+#include <format>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+//KHR_parallel_shader_compile, glad was generated without extensions
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+PendingShader::PendingShader(GLResources &resources, std::shared_ptr<ShaderCache> cache, uint64_t cacheKey, bool parallel) : 
+    resources(&resources), cache(cache), cacheKey(cacheKey), parallel(parallel), submitTime(std::chrono::steady_clock::now()), 
+    state(State::Compiling), vertId(0), fragId(0), program(0)
+{
+}
+
+PendingShader::~PendingShader() {
+    //abandoned before anyone picked it up
+    if (this->state == State::Compiling) {
+        GLDeletionQueue &deletionQueue = GLDeletionQueue::global();
+        deletionQueue.deleteShader(this->vertId);
+        deletionQueue.deleteShader(this->fragId);
+        deletionQueue.deleteProgram(this->program);
+    }
+}
+
+bool PendingShader::isReady() {
+    if (this->state == State::Compiling && this->parallel) {
+        int complete = 0;
+        glGetProgramiv(this->program, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) {
+            return false;
+        }
+        this->finish();
+    }
+    return this->state != State::Compiling || !this->parallel;
+}
+
+bool PendingShader::hasFailed() {
+    if (!this->isReady()) {
+        return false;
+    }
+    this->finish();
+    return this->state == State::Failed;
+}
+
+const std::string& PendingShader::getError() const {
+    return this->error;
+}
+
+ShaderHandle PendingShader::get() {
+    this->finish();
+    if (this->state == State::Failed) {
+        throw std::runtime_error(this->error);
+    }
+    return this->shader;
+}
+
+ShaderHandle PendingShader::getOr(ShaderHandle fallback) {
+    if (!this->isReady()) {
+        return fallback;
+    }
+    this->finish();
+    return this->state == State::Ready ? this->shader : fallback;
+}
+
+void PendingShader::finish() {
+    if (this->state != State::Compiling) {
+        return;
+    }
+
+    //first status query, without the parallel extension this is where we actually wait on the driver
+    int success = 0;
+    glGetProgramiv(this->program, GL_LINK_STATUS, &success);
+
+    if (!success) {
+        this->error = std::format("Failed to build shader program:\nvertex: {}\nfragment: {}\nlink: ", 
+                this->shaderLog(this->vertId), this->shaderLog(this->fragId));
+
+        char infoLog[512] = {};
+        glGetProgramInfoLog(this->program, 512, NULL, infoLog);
+        this->error += infoLog;
+    }
+
+    glDetachShader(this->program, this->vertId);
+    glDetachShader(this->program, this->fragId);
+    glDeleteShader(this->vertId);
+    glDeleteShader(this->fragId);
+
+    if (!success) {
+        glDeleteProgram(this->program);
+        this->state = State::Failed;
+        return;
+    }
+
+    if (this->cache) {
+        this->cache->store(this->cacheKey, this->program);
+    }
+
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->submitTime).count();
+    if (this->cache) {
+        this->cache->recordBuild(false, buildMs);
+    }
+
+    this->shader = this->resources->getShaders().adopt(std::unique_ptr<Shader>(new Shader(this->program, false, buildMs)));
+    this->state = State::Ready;
+}
+
+std::string PendingShader::shaderLog(unsigned int id) {
+    int success = 0;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+    if (success) {
+        return "ok";
+    }
+
+    char infoLog[512] = {};
+    glGetShaderInfoLog(id, 512, NULL, infoLog);
+    return infoLog;
+}
+
+ShaderCompiler::ShaderCompiler(GLResources &resources, std::shared_ptr<ShaderCache> cache) : 
+    resources(&resources), cache(cache), parallel(false)
+{
+    if (this->cache && !this->cache->isSupported()) {
+        this->cache = nullptr;
+    }
+
+    if (GLExtensions::has("GL_KHR_parallel_shader_compile") || GLExtensions::has("GL_ARB_parallel_shader_compile")) {
+        this->parallel = true;
+
+        //default thread count is implementation defined, ask for as many as the driver wants to give us
+        auto maxThreads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        if (!maxThreads) {
+            maxThreads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+        }
+        if (maxThreads) {
+            maxThreads(0xFFFFFFFF);
+        }
+    }
+}
+
+std::shared_ptr<PendingShader> ShaderCompiler::submit(const ShaderSource &source) {
+    uint64_t key = this->cache ? this->cache->makeKey(source.vert, source.frag) : 0;
+    auto pending = std::shared_ptr<PendingShader>(new PendingShader(*this->resources, this->cache, key, this->parallel));
+
+    pending->program = glCreateProgram();
+
+    //cache hits are already linked, no point deferring anything
+    if (this->cache) {
+        auto start = std::chrono::steady_clock::now();
+        if (this->cache->load(key, pending->program)) {
+            double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            this->cache->recordBuild(true, buildMs);
+
+            pending->shader = this->resources->getShaders().adopt(std::unique_ptr<Shader>(new Shader(pending->program, true, buildMs)));
+            pending->state = PendingShader::State::Ready;
+            return pending;
+        }
+        glProgramParameteri(pending->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    const char *vertC = source.vert.data(), *fragC = source.frag.data();
+    int vertLength = static_cast<int>(source.vert.size()), fragLength = static_cast<int>(source.frag.size());
+
+    pending->vertId = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pending->vertId, 1, &vertC, &vertLength);
+    glCompileShader(pending->vertId);
+
+    pending->fragId = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pending->fragId, 1, &fragC, &fragLength);
+    glCompileShader(pending->fragId);
+
+    //linking without checking compile status is fine, a failed compile just fails the link and we dig out the logs then
+    glAttachShader(pending->program, pending->vertId);
+    glAttachShader(pending->program, pending->fragId);
+    glLinkProgram(pending->program);
+
+    return pending;
+}
+
+bool ShaderCompiler::hasParallelCompile() const {
+    return this->parallel;
+}
@@ -0,0 +1,77 @@
+#ifndef SHADER_COMPILER_H
+#define SHADER_COMPILER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "shader.h"
+#include "shader_cache.h"
+#include "gl_resources.h"
+
+/** 
+ * Handle to a program thats still compiling. With KHR/ARB_parallel_shader_compile nothing on it blocks except get(),
+ * so the loop can keep drawing with a fallback and swap over once isReady() says so. Without it the first status
+ * query waits on the driver, whichever call makes it.
+ * */
+class PendingShader {
+    public:
+        ~PendingShader();
+
+        //non blocking when the driver has KHR/ARB_parallel_shader_compile, otherwise always true without checking anything
+        bool isReady();
+        bool hasFailed();
+        const std::string& getError() const;
+
+        //blocks until the program is linked, throws if compiling or linking failed. The program lives in the compilers GLResources
+        ShaderHandle get();
+        //hands back fallback until the program is ready (or if it failed). Only avoids blocking with parallel compile,
+        //otherwise isReady() is always true and this queries the link status, which waits on the driver
+        ShaderHandle getOr(ShaderHandle fallback);
+
+    private:
+        friend class ShaderCompiler;
+
+        enum class State {
+            Compiling,
+            Ready,
+            Failed
+        };
+
+        PendingShader(GLResources &resources, std::shared_ptr<ShaderCache> cache, uint64_t cacheKey, bool parallel);
+
+        GLResources *resources;
+        std::shared_ptr<ShaderCache> cache;
+        uint64_t cacheKey;
+        bool parallel;
+        std::chrono::steady_clock::time_point submitTime;
+
+        State state;
+        unsigned int vertId, fragId, program;
+        ShaderHandle shader;
+        std::string error;
+
+        void finish();
+        std::string shaderLog(unsigned int id);
+};
+
+class ShaderCompiler {
+    public:
+        //needs a current context, finished programs are added to resources
+        ShaderCompiler(GLResources &resources, std::shared_ptr<ShaderCache> cache = nullptr);
+
+        /** 
+         * Kicks off compiling and linking without querying any status, so submitting a whole batch 
+         * lets the driver work on all of them at once
+         * */
+        std::shared_ptr<PendingShader> submit(const ShaderSource &source);
+
+        bool hasParallelCompile() const;
+
+    private:
+        GLResources *resources;
+        std::shared_ptr<ShaderCache> cache;
+        bool parallel;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "shader_preprocessor.h"
+#include "embedded_shaders.h"
+
+#include <algorithm>
+#include <format>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    std::string_view trimStart(std::string_view str) {
+        size_t start = str.find_first_not_of(" \t");
+        return start == std::string_view::npos ? std::string_view() : str.substr(start);
+    }
+
+    //returns the name in #include "name" or #include <name>, nullopt if the line isnt an include
+    std::optional<std::string> parseInclude(std::string_view line) {
+        line = trimStart(line);
+        if (!line.starts_with("#")) {
+            return std::nullopt;
+        }
+        line = trimStart(line.substr(1));
+        if (!line.starts_with("include")) {
+            return std::nullopt;
+        }
+        line = trimStart(line.substr(7));
+
+        if (line.empty() || (line[0] != '"' && line[0] != '<')) {
+            throw std::runtime_error(std::format("Malformed shader include: {}", line));
+        }
+        char close = line[0] == '"' ? '"' : '>';
+        size_t end = line.find(close, 1);
+        if (end == std::string_view::npos) {
+            throw std::runtime_error(std::format("Malformed shader include: {}", line));
+        }
+        return std::string(line.substr(1, end - 1));
+    }
+}
+
+ShaderPreprocessor::ShaderPreprocessor() : 
+    ShaderPreprocessor([](const std::string &name) -> std::optional<std::string> {
+        auto source = EmbeddedShaders::find(name);
+        return source ? std::optional<std::string>(std::string(*source)) : std::nullopt;
+    })
+{
+}
+
+ShaderPreprocessor::ShaderPreprocessor(Loader loader) : 
+    loader(std::move(loader))
+{
+}
+
+std::string ShaderPreprocessor::definesKey(const ShaderDefines &defines) {
+    std::string key;
+    for (const auto &[name, value] : defines) {
+        key += name + "=" + value + ";";
+    }
+    return key;
+}
+
+PreprocessedShader ShaderPreprocessor::process(const std::string &name, const ShaderDefines &defines) const {
+    std::string defineBlock;
+    for (const auto &[define, value] : defines) {
+        defineBlock += std::format("#define {} {}\n", define, value);
+    }
+
+    PreprocessedShader result;
+    this->append(name, result.source, result.files, &defineBlock);
+
+    //no #version to put them after, so they go first
+    if (!defineBlock.empty() && !result.source.starts_with("#version") && result.source.find("\n#version") == std::string::npos) {
+        result.source = defineBlock + "#line 1 0\n" + result.source;
+    }
+    return result;
+}
+
+const PreprocessedShader& ShaderPreprocessor::get(const std::string &name, const ShaderDefines &defines) {
+    std::string key = name + "|" + definesKey(defines);
+    auto it = this->processed.find(key);
+    if (it == this->processed.end()) {
+        it = this->processed.emplace(key, this->process(name, defines)).first;
+    }
+    return it->second;
+}
+
+void ShaderPreprocessor::append(const std::string &name, std::string &out, std::vector<std::string> &files, 
+        const std::string *defineBlock) const 
+{
+    //include once, also stops include cycles
+    if (std::find(files.begin(), files.end(), name) != files.end()) {
+        return;
+    }
+
+    auto source = this->loader(name);
+    if (!source) {
+        throw std::runtime_error(std::format("Shader file not found: {}", name));
+    }
+
+    size_t fileIndex = files.size();
+    files.push_back(name);
+
+    std::istringstream lines(*source);
+    std::string line;
+    int lineNumber = 0;
+    bool root = defineBlock != nullptr;
+
+    //source strings start at line 1 unless something says otherwise
+    if (!root) {
+        out += std::format("#line 1 {}\n", fileIndex);
+    }
+
+    while (std::getline(lines, line)) {
+        lineNumber++;
+
+        if (trimStart(line).starts_with("#version")) {
+            //only the root files version counts, and defines have to come right after it
+            if (root) {
+                out += line + "\n";
+                out += *defineBlock;
+                out += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+            }
+            continue;
+        }
+
+        if (auto include = parseInclude(line)) {
+            this->append(*include, out, files, nullptr);
+            out += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+            continue;
+        }
+
+        out += line + "\n";
+    }
+}
+
+ShaderVariantCache::ShaderVariantCache(GLResources &resources, std::shared_ptr<ShaderCache> binaryCache) : 
+    resources(&resources), binaryCache(binaryCache)
+{
+}
+
+ShaderVariantCache::ShaderVariantCache(GLResources &resources, ShaderPreprocessor preprocessor, std::shared_ptr<ShaderCache> binaryCache) : 
+    resources(&resources), preprocessor(std::move(preprocessor)), binaryCache(binaryCache)
+{
+}
+
+ShaderHandle ShaderVariantCache::get(const std::string &vertName, const std::string &fragName, const ShaderDefines &defines) {
+    std::string key = vertName + "|" + fragName + "|" + ShaderPreprocessor::definesKey(defines);
+    auto it = this->programs.find(key);
+    if (it != this->programs.end() && this->resources->getShaders().isAlive(it->second)) {
+        return it->second;
+    }
+
+    auto shader = this->resources->getShaders().create(this->getSource(vertName, fragName, defines), this->binaryCache);
+    this->programs.insert_or_assign(std::move(key), shader);
+    return shader;
+}
+
+ShaderSource ShaderVariantCache::getSource(const std::string &vertName, const std::string &fragName, const ShaderDefines &defines) {
+    //views into the preprocessors cache, which never drops entries
+    return {
+        this->preprocessor.get(vertName, defines).source,
+        this->preprocessor.get(fragName, defines).source
+    };
+}
+
+size_t ShaderVariantCache::size() const {
+    return this->programs.size();
+}
@@ -0,0 +1,70 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shader.h"
+#include "shader_cache.h"
+#include "gl_resources.h"
+
+//ordered so the same set of defines always gives the same key
+using ShaderDefines = std::map<std::string, std::string>;
+
+struct PreprocessedShader {
+    std::string source;
+    std::vector<std::string> files;     //root file first, index matches the source string number in #line
+};
+
+/** 
+ * Resolves #include "name" (each file at most once per shader) and injects defines right after #version,
+ * emitting #line directives so compiler errors still point at the right file and line
+ * */
+class ShaderPreprocessor {
+    public:
+        using Loader = std::function<std::optional<std::string>(const std::string &name)>;
+
+        //defaults to the embedded shaders
+        ShaderPreprocessor();
+        ShaderPreprocessor(Loader loader);
+
+        static std::string definesKey(const ShaderDefines &defines);
+
+        PreprocessedShader process(const std::string &name, const ShaderDefines &defines) const;
+        //same as process but remembers the result per (name, defines)
+        const PreprocessedShader& get(const std::string &name, const ShaderDefines &defines);
+
+    private:
+        Loader loader;
+        std::unordered_map<std::string, PreprocessedShader> processed;
+
+        void append(const std::string &name, std::string &out, std::vector<std::string> &files, 
+                const std::string *defineBlock) const;
+};
+
+/** 
+ * Compiles each (vert, frag, defines) combination once into resources and hands out the same program afterwards,
+ * unless someone released it in the meantime
+ * */
+class ShaderVariantCache {
+    public:
+        ShaderVariantCache(GLResources &resources, std::shared_ptr<ShaderCache> binaryCache = nullptr);
+        ShaderVariantCache(GLResources &resources, ShaderPreprocessor preprocessor, std::shared_ptr<ShaderCache> binaryCache = nullptr);
+
+        ShaderHandle get(const std::string &vertName, const std::string &fragName, const ShaderDefines &defines = {});
+        ShaderSource getSource(const std::string &vertName, const std::string &fragName, const ShaderDefines &defines = {});
+
+        size_t size() const;
+
+    private:
+        GLResources *resources;
+        ShaderPreprocessor preprocessor;
+        std::shared_ptr<ShaderCache> binaryCache;
+        std::unordered_map<std::string, ShaderHandle> programs;
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "shader_watcher.h"
+#include "gl_loader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+ShaderWatcher::ShaderWatcher(GLFWwindow *mainWindow, GLResources &resources, std::filesystem::path directory) : 
+    resources(&resources), directory(std::move(directory)), context(nullptr), inotifyFd(-1), wakeFd(-1),
+    preprocessor([this](const std::string &name) { return this->readFile(name); })
+{
+    this->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->inotifyFd < 0) {
+        throw std::runtime_error(std::format("Failed to init inotify: {}", std::strerror(errno)));
+    }
+
+    //IN_MOVED_TO catches editors that write a temp file and rename it over
+    if (inotify_add_watch(this->inotifyFd, this->directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(this->inotifyFd);
+        throw std::runtime_error(std::format("Failed to watch {}: {}", this->directory.string(), std::strerror(errno)));
+    }
+
+    this->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    this->context = glfwCreateWindow(1, 1, "shader reload", NULL, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (this->context == NULL) {
+        close(this->inotifyFd);
+        close(this->wakeFd);
+        throw std::runtime_error("Failed to create shader reload context");
+    }
+
+    //the reload thread calls GL too, no lazy entry point may be left to patch itself once it runs
+    GLLoader::resolveAll();
+    this->worker = std::thread(&ShaderWatcher::run, this);
+}
+
+ShaderWatcher::~ShaderWatcher() {
+    uint64_t one = 1;
+    write(this->wakeFd, &one, sizeof(one));
+    this->worker.join();
+
+    glfwDestroyWindow(this->context);
+    close(this->inotifyFd);
+    close(this->wakeFd);
+}
+
+void ShaderWatcher::watch(ShaderHandle shader, const std::string &vertName, const std::string &fragName, 
+        const ShaderDefines &defines) 
+{
+    //setup time only, resolves the include graph so we know which files to react to
+    Watch watch{shader, vertName, fragName, defines, {}};
+    for (const auto &name : {vertName, fragName}) {
+        try {
+            auto files = this->preprocessor.process(name, defines).files;
+            watch.files.insert(watch.files.end(), files.begin(), files.end());
+        } catch (const std::exception &) {
+            watch.files.push_back(name);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->watchesMutex);
+    this->watches.push_back(std::move(watch));
+}
+
+bool ShaderWatcher::poll() {
+    std::vector<Reloaded> ready;
+    {
+        //only ever held for a push_back on the other side, never across io or compiling
+        std::lock_guard<std::mutex> lock(this->reloadedMutex);
+        ready.swap(this->reloaded);
+    }
+
+    bool swapped = false;
+    for (auto &entry : ready) {
+        if (Shader *target = this->resources->getShaders().tryGet(entry.target)) {
+            target->swapProgram(*entry.shader);
+            swapped = true;
+        }
+        //entry.shader now holds the old program and deletes it here, on the render thread
+    }
+
+    //the pool is render thread only, so this is the place to notice released programs
+    if (!ready.empty()) {
+        std::lock_guard<std::mutex> lock(this->watchesMutex);
+        std::erase_if(this->watches, [this](const Watch &watch) { 
+            return !this->resources->getShaders().isAlive(watch.shader); 
+        });
+    }
+    return swapped;
+}
+
+void ShaderWatcher::run() {
+    glfwMakeContextCurrent(this->context);
+
+    pollfd fds[2] = {
+        {this->inotifyFd, POLLIN, 0},
+        {this->wakeFd, POLLIN, 0}
+    };
+
+    alignas(inotify_event) char buf[4096];
+    std::vector<std::string> changed;
+
+    while (true) {
+        //block until something happens, then keep collecting until the editor is done writing
+        int timeout = changed.empty() ? -1 : DEBOUNCE_MS;
+        int ret = ::poll(fds, 2, timeout);
+        if (ret < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+
+        if (ret == 0) {
+            this->reload(changed);
+            changed.clear();
+            continue;
+        }
+
+        ssize_t len;
+        while ((len = read(this->inotifyFd, buf, sizeof(buf))) > 0) {
+            for (char *ptr = buf; ptr < buf + len; ) {
+                auto event = reinterpret_cast<inotify_event*>(ptr);
+                if (event->len > 0) {
+                    std::string name(event->name);
+                    if (std::find(changed.begin(), changed.end(), name) == changed.end()) {
+                        changed.push_back(std::move(name));
+                    }
+                }
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+    glfwMakeContextCurrent(NULL);
+}
+
+void ShaderWatcher::reload(const std::vector<std::string> &changed) {
+    std::vector<Watch> affected;
+    {
+        std::lock_guard<std::mutex> lock(this->watchesMutex);
+        for (const auto &watch : this->watches) {
+            bool touched = std::find_first_of(changed.begin(), changed.end(), watch.files.begin(), watch.files.end()) != changed.end();
+            if (touched) {
+                affected.push_back(watch);
+            }
+        }
+    }
+
+    for (const auto &watch : affected) {
+        try {
+            auto vert = this->preprocessor.process(watch.vertName, watch.defines);
+            auto frag = this->preprocessor.process(watch.fragName, watch.defines);
+            auto shader = std::make_unique<Shader>(ShaderSource{vert.source, frag.source});
+
+            //includes may have been added or removed
+            {
+                std::lock_guard<std::mutex> lock(this->watchesMutex);
+                for (auto &existing : this->watches) {
+                    if (existing.vertName == watch.vertName && existing.fragName == watch.fragName && existing.defines == watch.defines) {
+                        existing.files = vert.files;
+                        existing.files.insert(existing.files.end(), frag.files.begin(), frag.files.end());
+                    }
+                }
+            }
+
+            //the render context may only touch the program once its fully built on ours
+            glFinish();
+
+            std::lock_guard<std::mutex> lock(this->reloadedMutex);
+            this->reloaded.push_back({watch.shader, std::move(shader)});
+        } catch (const std::exception &e) {
+            std::cerr << std::format("Shader reload of {} + {} failed, keeping the old program: {}\n", 
+                    watch.vertName, watch.fragName, e.what());
+        }
+    }
+
+    //wake the render loop in case its idling in glfwWaitEvents
+    if (!affected.empty()) {
+        glfwPostEmptyEvent();
+    }
+}
+
+std::optional<std::string> ShaderWatcher::readFile(const std::string &name) {
+    std::ifstream file(this->directory / name);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    std::stringstream fileBuff;
+    fileBuff << file.rdbuf();
+    return fileBuff.str();
+}
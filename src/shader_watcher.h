@@ -0,0 +1,77 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "gl_resources.h"
+
+struct GLFWwindow;
+
+/** 
+ * Watches a shader directory with inotify and rebuilds the programs using changed files on a background thread,
+ * with its own hidden context shared with the main window. The render thread only ever swaps finished programs in.
+ * Linux only.
+ * */
+class ShaderWatcher {
+    public:
+        //has to be constructed and destroyed on the main thread (glfw window rules), reloads are swapped into programs in resources
+        ShaderWatcher(GLFWwindow *mainWindow, GLResources &resources, std::filesystem::path directory);
+        ~ShaderWatcher();
+
+        ShaderWatcher(const ShaderWatcher&) = delete;
+        ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+        /** 
+         * Names are relative to the watched directory. The sources go through the preprocessor with defines,
+         * and editing any file they include triggers a reload too
+         * */
+        void watch(ShaderHandle shader, const std::string &vertName, const std::string &fragName, 
+                const ShaderDefines &defines = {});
+
+        /** 
+         * Call once per frame on the render thread. Never waits on io or the compiler, 
+         * returns true if any program got swapped in. Drops watches on released programs
+         * */
+        bool poll();
+
+    private:
+        //how long to wait for more events before reloading, editors tend to write files in several steps
+        static constexpr int DEBOUNCE_MS = 50;
+
+        struct Watch {
+            ShaderHandle shader;
+            std::string vertName, fragName;
+            ShaderDefines defines;
+            std::vector<std::string> files;     //everything the program was built from
+        };
+
+        struct Reloaded {
+            ShaderHandle target;
+            std::unique_ptr<Shader> shader;
+        };
+
+        GLResources *resources;
+        std::filesystem::path directory;
+        GLFWwindow *context;
+        int inotifyFd, wakeFd;
+        std::thread worker;
+
+        std::mutex watchesMutex;
+        std::vector<Watch> watches;
+        ShaderPreprocessor preprocessor;
+
+        std::mutex reloadedMutex;
+        std::vector<Reloaded> reloaded;
+
+        void run();
+        void reload(const std::vector<std::string> &changed);
+        std::optional<std::string> readFile(const std::string &name);
+};
+
+#endif
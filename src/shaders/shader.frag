@@ -2,7 +2,16 @@
 
 out vec4 FragColor;
 
+#ifdef STATIC_BATCH
+in vec4 vertexColor;
+#else
 uniform vec3 color;
+#endif
+
 void main() {
+#ifdef STATIC_BATCH
+    FragColor = vertexColor;
+#else
     FragColor = vec4(color.r, color.g, color.b, 1.0);
+#endif
 }
@@ -2,7 +2,32 @@
 
 layout (location = 0) in vec3 aPos;
 
+#ifdef STATIC_BATCH
+//StaticBatch already moved the vertices into place and baked the color into each of them
+layout (location = 1) in vec4 aColor;
+out vec4 vertexColor;
+#else
 uniform vec3 offset;
+#endif
+
+#ifdef LATE_LATCH
+//written right before the draw, see LateLatchBuffer
+layout (std140) uniform LateLatch {
+    vec4 latchOffsets[LATE_LATCH_SLOTS];
+};
+uniform int latchSlot;
+#endif
+
 void main() {
-    gl_Position = vec4(aPos.x + offset.x, aPos.y + offset.y, aPos.z + offset.z, 1.0);
+#ifdef STATIC_BATCH
+    //static squares never move, so no latching either
+    vertexColor = aColor;
+    gl_Position = vec4(aPos, 1.0);
+#else
+    vec3 pos = aPos + offset;
+#ifdef LATE_LATCH
+    pos += latchOffsets[latchSlot].xyz;
+#endif
+    gl_Position = vec4(pos, 1.0);
+#endif
 }
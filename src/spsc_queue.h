@@ -0,0 +1,55 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/** 
+ * Fixed size lock free ring for exactly one producer thread and one consumer thread.
+ * Each side caches the other sides index so it only touches the shared cache line when it looks full/empty
+ * */
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+    public:
+        SpscQueue() : head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+        //producer only, false if full
+        bool push(const T &value) {
+            size_t head = this->head.load(std::memory_order_relaxed);
+            if (head - this->cachedTail == Capacity) {
+                this->cachedTail = this->tail.load(std::memory_order_acquire);
+                if (head - this->cachedTail == Capacity) {
+                    return false;
+                }
+            }
+            this->slots[head & (Capacity - 1)] = value;
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        //consumer only, false if empty
+        bool pop(T &value) {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail == this->cachedHead) {
+                this->cachedHead = this->head.load(std::memory_order_acquire);
+                if (tail == this->cachedHead) {
+                    return false;
+                }
+            }
+            value = this->slots[tail & (Capacity - 1)];
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> head;
+        size_t cachedTail;
+        alignas(64) std::atomic<size_t> tail;
+        size_t cachedHead;
+        alignas(64) std::array<T, Capacity> slots;
+};
+
+#endif
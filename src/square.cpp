@@ -1,44 +1,116 @@
 #include "square.h"
 #include "gameboard_utils.h"
 
-#include "shader.h"
-#include "vao_wrapper.h"
+#include "gl_resources.h"
 #include <array>
 #include <memory>
 
-Square::Square(std::shared_ptr<VaoWrapper> vao, std::shared_ptr<Shader> shader, std::array<float, 3> color, GLPos pos) : 
-    vao(vao), pos(std::move(pos)), color(std::move(color)), shader(shader), posChanged(true) 
+Square::Square(GLResources &resources, VaoHandle vao, ShaderHandle shader, std::array<float, 3> color, GLPos pos) : 
+    resources(&resources), vao(vao), pos(std::move(pos)), color(std::move(color)), shader(shader), staticBatch(nullptr), posChanged(true), latchSlot(-1) 
 { 
 }
 
+Square::~Square() {
+    //no damage marking here, the VAO might already be gone
+    if (this->staticBatch) {
+        this->staticBatch->remove(this->staticEntry);
+    }
+}
+
 void Square::setPos(GLPos pos) {
+    this->markDamaged();
     this->pos = pos;
+    this->posChanged = true;
+    this->updateStatic();
+    this->markDamaged();
 }
 
 void Square::translatePos(const GLPos& movementVector) {
+    this->markDamaged();
     this->pos.x += movementVector.x;
     this->pos.y += movementVector.y;
     this->pos.z += movementVector.z;
     this->posChanged = true;
+    this->updateStatic();
+    this->markDamaged();
 }
 
 
 void Square::setColor(std::array<float, 3> color) {
     this->color = std::move(color);
+    this->updateStatic();
+    this->markDamaged();
+}
+
+void Square::setLatchSlot(int slot) {
+    this->latchSlot = slot;
+}
+
+void Square::setStatic(StaticBatch *batch) {
+    if (this->staticBatch == batch) {
+        return;
+    }
+    if (this->staticBatch) {
+        this->staticBatch->remove(this->staticEntry);
+        this->staticEntry = {};
+    }
+    this->staticBatch = batch;
+    if (this->staticBatch) {
+        this->staticEntry = this->staticBatch->add(this->pos, this->color);
+    }
+    this->markDamaged();
+}
+
+bool Square::isStatic() const {
+    return this->staticBatch != nullptr;
+}
+
+void Square::setDamageTracker(std::shared_ptr<DamageTracker> damageTracker) {
+    this->damageTracker = damageTracker;
+    this->markDamaged();
+}
+
+DamageRect Square::getBounds() const {
+    DamageRect bounds = this->resources->get(this->vao).getBounds();
+    return {
+        bounds.minX + this->pos.x,
+        bounds.minY + this->pos.y,
+        bounds.maxX + this->pos.x,
+        bounds.maxY + this->pos.y
+    };
+}
+
+void Square::markDamaged() {
+    if (this->damageTracker) {
+        this->damageTracker->markRect(this->getBounds());
+    }
+}
+
+void Square::updateStatic() {
+    if (this->staticBatch) {
+        this->staticBatch->update(this->staticEntry, this->pos, this->color);
+    }
 }
 
 void Square::draw() {
-    this->shader->bind();
-    this->shader->set3f("color", this->color);
+    //the batch draws it
+    if (this->staticBatch) {
+        return;
+    }
+    Shader &shader = this->resources->get(this->shader);
+    shader.bind();
+    shader.set3f("color", this->color);
 
     if (this->posChanged) {
         this->cachedPos = {pos.x, pos.y, pos.z};
         this->posChanged = false;
     }
 
-    this->shader->set3f("offset", this->cachedPos);
+    shader.set3f("offset", this->cachedPos);
+    if (this->latchSlot >= 0) {
+        shader.setInt("latchSlot", this->latchSlot);
+    }
     this->posChanged = false;
 
-    this->vao->reBindVertexBuff();
-    this->vao->draw();
+    this->resources->get(this->vao).draw();
 }
@@ -3,31 +3,59 @@
 
 #include <memory>
 #include <array>
-#include "shader.h"
-#include "vao_wrapper.h"
+#include "gl_resources.h"
 #include "gameboard_utils.h"
+#include "damage_tracker.h"
+#include "static_batch.h"
 
 class Square {
     public:
         /** 
-         * Expects Pos to be in screenspace coordinates! Use utils function to translate from game coordinates
+         * Expects Pos to be in screenspace coordinates! Use utils function to translate from game coordinates.
+         * The handles are resolved through resources on every draw, which has to outlive the square
          * */
-        Square(std::shared_ptr<VaoWrapper> vao, std::shared_ptr<Shader> shader, std::array<float, 3> color, GLPos pos);
+        Square(GLResources &resources, VaoHandle vao, ShaderHandle shader, std::array<float, 3> color, GLPos pos);
+        ~Square();
+
+        Square(const Square&) = delete;
+        Square& operator=(const Square&) = delete;
 
         void setPos(GLPos pos);
         void translatePos(const GLPos& movementVector);
         void draw();
         void setColor(std::array<float, 3> color);
+        //slot in the LateLatch block, only for shaders built with LATE_LATCH
+        void setLatchSlot(int slot);
+
+        /** 
+         * Static squares are drawn by batch (which has to be built from the same mesh as the squares VAO and outlive it) 
+         * instead of by draw(), moving or recoloring one rewrites its slot in the batch. nullptr makes it draw itself again
+         * */
+        void setStatic(StaticBatch *batch);
+        bool isStatic() const;
+
+        //mutations mark the old and new screen area as damaged on this tracker
+        void setDamageTracker(std::shared_ptr<DamageTracker> damageTracker);
+        DamageRect getBounds() const;
+
         GLPos pos;
 
     private:
-        std::shared_ptr<VaoWrapper> vao;
-        std::shared_ptr<Shader> shader;
+        GLResources *resources;
+        VaoHandle vao;
+        ShaderHandle shader;
+        std::shared_ptr<DamageTracker> damageTracker;
+        StaticBatch *staticBatch;
+        StaticBatch::EntryHandle staticEntry;
 
         std::array<float, 3> color;
 
         std::array<float, 3> cachedPos;
 
         bool posChanged;
+        int latchSlot;
+
+        void markDamaged();
+        void updateStatic();
 };
 #endif
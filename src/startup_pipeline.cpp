@@ -0,0 +1,48 @@
+#include "startup_pipeline.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+
+StartupPipeline::StartupPipeline() : 
+    start(Clock::now()), firstFrameMs(-1)
+{
+}
+
+void StartupPipeline::markFirstFrame() {
+    if (this->firstFrameMs < 0) {
+        this->firstFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - this->start).count();
+    }
+}
+
+void StartupPipeline::printTimings() const {
+    std::vector<Stage> sorted;
+    {
+        std::lock_guard<std::mutex> lock(this->stagesMutex);
+        sorted = this->stages;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Stage &a, const Stage &b) {
+        return a.startMs < b.startMs;
+    });
+
+    std::cout << "startup timings:\n";
+    for (const auto &stage : sorted) {
+        std::cout << std::format("  {:<7} {:<28} {:>8.3f}ms -> {:>8.3f}ms ({:.3f}ms)\n", 
+                stage.serial ? "[gl]" : "[worker]", stage.name, stage.startMs, stage.endMs, stage.endMs - stage.startMs);
+    }
+    if (this->firstFrameMs >= 0) {
+        std::cout << std::format("  time to first frame: {:.3f}ms\n", this->firstFrameMs);
+    }
+}
+
+void StartupPipeline::record(const std::string &name, bool serial, Clock::time_point stageStart, Clock::time_point stageEnd) {
+    Stage stage{
+        name, 
+        serial, 
+        std::chrono::duration<double, std::milli>(stageStart - this->start).count(),
+        std::chrono::duration<double, std::milli>(stageEnd - this->start).count()
+    };
+
+    std::lock_guard<std::mutex> lock(this->stagesMutex);
+    this->stages.push_back(std::move(stage));
+}
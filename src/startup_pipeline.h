@@ -0,0 +1,78 @@
+#ifndef STARTUP_PIPELINE_H
+#define STARTUP_PIPELINE_H
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** 
+ * Runs the independent parts of startup on worker threads while the GL thread does the context work,
+ * and keeps a per stage timing breakdown. Anything touching GL has to go through runSerial.
+ * */
+class StartupPipeline {
+    public:
+        StartupPipeline();
+
+        //starts fn on its own thread straight away
+        template<typename F>
+        auto runAsync(const std::string &name, F fn) -> std::shared_future<decltype(fn())> {
+            return std::async(std::launch::async, [this, name, fn = std::move(fn)]() {
+                auto start = Clock::now();
+                if constexpr (std::is_void_v<decltype(fn())>) {
+                    fn();
+                    this->record(name, false, start, Clock::now());
+                } else {
+                    auto result = fn();
+                    this->record(name, false, start, Clock::now());
+                    return result;
+                }
+            }).share();
+        }
+
+        //runs fn on the calling thread, which should be the one owning the context
+        template<typename F>
+        auto runSerial(const std::string &name, F fn) -> decltype(fn()) {
+            auto start = Clock::now();
+            if constexpr (std::is_void_v<decltype(fn())>) {
+                fn();
+                this->record(name, true, start, Clock::now());
+            } else {
+                auto result = fn();
+                this->record(name, true, start, Clock::now());
+                return result;
+            }
+        }
+
+        //blocks on a worker stage, time spent waiting shows up in the breakdown so stalls are easy to spot
+        template<typename T>
+        const T& wait(const std::string &name, const std::shared_future<T> &future) {
+            auto start = Clock::now();
+            const T &result = future.get();
+            this->record("wait: " + name, true, start, Clock::now());
+            return result;
+        }
+
+        void markFirstFrame();
+        void printTimings() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stage {
+            std::string name;
+            bool serial;
+            double startMs, endMs;
+        };
+
+        Clock::time_point start;
+        double firstFrameMs;
+
+        mutable std::mutex stagesMutex;
+        std::vector<Stage> stages;
+
+        void record(const std::string &name, bool serial, Clock::time_point stageStart, Clock::time_point stageEnd);
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "static_batch.h"
+#include "gl_deletion_queue.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+StaticBatch::StaticBatch(GLResources &resources, ShaderHandle shader, const MeshData &mesh, uint32_t slotCapacity) : 
+    resources(&resources), shader(shader), vao(0), vertexBuf(0), indexBuf(0), meshVertices(mesh.vertices), meshIndices(mesh.indices), 
+    slotVertexCount(static_cast<uint32_t>(mesh.vertices.size() / 3)), entries("static batch entry"), slotCapacity(std::max(slotCapacity, 1u)), 
+    dirtyBegin(0), dirtyEnd(0), reallocate(true), reallocations(0), uploadedBytes(0)
+{
+    if (mesh.vertices.size() % 3 != 0) {
+        throw std::runtime_error(std::format("Static batch mesh has {} floats, not whole xyz positions", mesh.vertices.size()));
+    }
+    for (unsigned int index : mesh.indices) {
+        if (index >= this->slotVertexCount) {
+            throw std::runtime_error(std::format("Static batch mesh index {} is past its {} vertices", index, this->slotVertexCount));
+        }
+    }
+
+    unsigned int bufs[2]{};
+    glGenVertexArrays(1, &this->vao);
+    glGenBuffers(2, bufs);
+    this->vertexBuf = bufs[0], this->indexBuf = bufs[1];
+
+    glBindVertexArray(this->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuf);
+    ColorVertex::Layout::format().apply();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->indexBuf);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+StaticBatch::~StaticBatch() {
+    GLDeletionQueue &deletionQueue = GLDeletionQueue::global();
+    deletionQueue.deleteVertexArray(this->vao);
+    deletionQueue.deleteBuffer(this->vertexBuf);
+    deletionQueue.deleteBuffer(this->indexBuf);
+}
+
+StaticBatch::EntryHandle StaticBatch::add(const GLPos &pos, const std::array<float, 3> &color) {
+    uint32_t slot = static_cast<uint32_t>(this->owners.size());
+    if (slot == this->slotCapacity) {
+        //buffers get recreated at the new size on the next draw, until then only the cpu copy grows
+        this->slotCapacity *= 2;
+        this->reallocate = true;
+    }
+
+    EntryHandle entry = this->entries.create(Entry{slot});
+    this->owners.push_back(entry);
+    this->vertices.resize(this->owners.size() * this->slotVertexCount);
+    this->writeSlot(slot, pos, color);
+    return entry;
+}
+
+void StaticBatch::update(EntryHandle entry, const GLPos &pos, const std::array<float, 3> &color) {
+    this->writeSlot(this->entries.get(entry).slot, pos, color);
+}
+
+void StaticBatch::remove(EntryHandle entry) {
+    uint32_t slot = this->entries.get(entry).slot;
+    uint32_t last = static_cast<uint32_t>(this->owners.size() - 1);
+
+    //keep the slots packed, the last one moves into the hole and is the only one that needs uploading
+    if (slot != last) {
+        std::copy_n(this->vertices.begin() + static_cast<size_t>(last) * this->slotVertexCount, this->slotVertexCount, 
+                this->vertices.begin() + static_cast<size_t>(slot) * this->slotVertexCount);
+        this->owners[slot] = this->owners[last];
+        this->entries.get(this->owners[slot]).slot = slot;
+        this->markDirty(slot);
+    }
+    this->owners.pop_back();
+    this->vertices.resize(this->owners.size() * this->slotVertexCount);
+    //slots past the end dont get drawn, so there is nothing to upload for them
+    this->dirtyEnd = std::min(this->dirtyEnd, last);
+    if (this->dirtyBegin >= this->dirtyEnd) {
+        this->dirtyBegin = this->dirtyEnd = 0;
+    }
+
+    this->entries.release(entry);
+    this->entries.collect();
+}
+
+void StaticBatch::draw() {
+    if (this->owners.empty()) {
+        return;
+    }
+    this->upload();
+
+    this->resources->get(this->shader).bind();
+    glBindVertexArray(this->vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(this->owners.size() * this->meshIndices.size()), GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+}
+
+size_t StaticBatch::size() const {
+    return this->owners.size();
+}
+
+StaticBatch::Stats StaticBatch::getStats() const {
+    return {this->owners.size(), this->slotCapacity, this->reallocations, this->uploadedBytes};
+}
+
+void StaticBatch::writeSlot(uint32_t slot, const GLPos &pos, const std::array<float, 3> &color) {
+    ColorVertex *out = this->vertices.data() + static_cast<size_t>(slot) * this->slotVertexCount;
+    for (uint32_t i = 0; i < this->slotVertexCount; i++) {
+        out[i] = {
+            this->meshVertices[i * 3] + pos.x, this->meshVertices[i * 3 + 1] + pos.y, this->meshVertices[i * 3 + 2] + pos.z,
+            color[0], color[1], color[2], 1.0f
+        };
+    }
+    this->markDirty(slot);
+}
+
+void StaticBatch::markDirty(uint32_t slot) {
+    if (this->dirtyBegin == this->dirtyEnd) {
+        this->dirtyBegin = slot;
+        this->dirtyEnd = slot + 1;
+    } else {
+        this->dirtyBegin = std::min(this->dirtyBegin, slot);
+        this->dirtyEnd = std::max(this->dirtyEnd, slot + 1);
+    }
+}
+
+void StaticBatch::upload() {
+    const size_t slotBytes = static_cast<size_t>(this->slotVertexCount) * sizeof(ColorVertex);
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuf);
+    if (this->reallocate) {
+        //index pattern is the same for every slot, just offset, so it only changes with the capacity
+        std::vector<unsigned int> indices;
+        indices.reserve(static_cast<size_t>(this->slotCapacity) * this->meshIndices.size());
+        for (uint32_t slot = 0; slot < this->slotCapacity; slot++) {
+            for (unsigned int index : this->meshIndices) {
+                indices.push_back(slot * this->slotVertexCount + index);
+            }
+        }
+        glBindVertexArray(this->vao);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(this->slotCapacity * slotBytes), nullptr, GL_DYNAMIC_DRAW);
+        this->dirtyBegin = 0;
+        this->dirtyEnd = static_cast<uint32_t>(this->owners.size());
+        this->reallocate = false;
+        this->reallocations++;
+    }
+
+    if (this->dirtyBegin != this->dirtyEnd) {
+        size_t bytes = (this->dirtyEnd - this->dirtyBegin) * slotBytes;
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(this->dirtyBegin * slotBytes), static_cast<GLsizeiptr>(bytes), 
+                this->vertices.data() + static_cast<size_t>(this->dirtyBegin) * this->slotVertexCount);
+        this->uploadedBytes += bytes;
+        this->dirtyBegin = this->dirtyEnd = 0;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,80 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "gameboard_utils.h"
+#include "gl_resources.h"
+#include "resource_pool.h"
+#include "vao_wrapper.h"
+#include "vertex_quantize.h"
+
+/**
+ * Copies of one mesh, already moved to their positions and with the color baked into every vertex, packed into a
+ * single vertex buffer and drawn with one glDrawElements. Meant for squares that never move (see Square::setStatic),
+ * the shader has to be built with STATIC_BATCH.
+ * Every entry takes one fixed size slot, the slots stay packed at the front so removing one moves the last into its place.
+ * Changes only touch the cpu copy, draw() uploads the slots that changed since the last draw in one go.
+ * Needs a current context, GL thread only
+ * */
+class StaticBatch {
+    public:
+        struct Entry {
+            uint32_t slot;
+        };
+        using EntryHandle = Handle<Entry>;
+
+        struct Stats {
+            size_t entryCount;
+            uint32_t slotCapacity;
+            //whole buffer reallocations, happen when the slots run out
+            uint64_t reallocations;
+            //vertex bytes sent by draw() so far
+            uint64_t uploadedBytes;
+        };
+
+        //mesh is the local space mesh every entry gets a copy of, resources has to outlive the batch
+        StaticBatch(GLResources &resources, ShaderHandle shader, const MeshData &mesh, uint32_t slotCapacity = 64);
+        ~StaticBatch();
+
+        StaticBatch(const StaticBatch&) = delete;
+        StaticBatch& operator=(const StaticBatch&) = delete;
+
+        EntryHandle add(const GLPos &pos, const std::array<float, 3> &color);
+        void update(EntryHandle entry, const GLPos &pos, const std::array<float, 3> &color);
+        void remove(EntryHandle entry);
+
+        //binds the batch shader, does nothing if the batch is empty
+        void draw();
+
+        size_t size() const;
+        Stats getStats() const;
+
+    private:
+        GLResources *resources;
+        ShaderHandle shader;
+        unsigned int vao, vertexBuf, indexBuf;
+
+        std::vector<float> meshVertices;
+        std::vector<unsigned int> meshIndices;
+        uint32_t slotVertexCount;
+
+        //cpu copy of every slot, owners[slot] is the entry in it
+        std::vector<ColorVertex> vertices;
+        std::vector<EntryHandle> owners;
+        ResourcePool<Entry> entries;
+        uint32_t slotCapacity;
+
+        //slots [dirtyBegin, dirtyEnd) changed since the last upload
+        uint32_t dirtyBegin, dirtyEnd;
+        bool reallocate;
+        uint64_t reallocations, uploadedBytes;
+
+        void writeSlot(uint32_t slot, const GLPos &pos, const std::array<float, 3> &color);
+        void markDirty(uint32_t slot);
+        void upload();
+};
+
+#endif
@@ -1,4 +1,8 @@
 #include "vao_wrapper.h"
+#include "gl_deletion_queue.h"
+#include "mesh_optimizer.h"
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 extern "C" {
@@ -7,11 +11,25 @@ extern "C" {
 #include <GL/gl.h>
 }
 
-VaoWrapper::VaoWrapper(const std::shared_ptr<std::vector<float>> vertices, const std::shared_ptr<std::vector<unsigned int>> indices) {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->currentIndexSize = indices->size();
+VaoWrapper::VaoWrapper(const MeshData &mesh) : 
+    VaoWrapper(std::span<const float>(mesh.vertices), mesh.indices)
+{
+}
+
+VaoWrapper::VaoWrapper(std::span<const float> vertices, std::span<const unsigned int> indices, std::optional<DamageRect> bounds) : 
+    VaoWrapper(PositionVertex::Layout::format(), std::as_bytes(vertices), indices, bounds)
+{
+}
 
+VaoWrapper::VaoWrapper(const VertexFormat &format, std::span<const std::byte> vertices, std::span<const unsigned int> indices, 
+        std::optional<DamageRect> bounds) : 
+    format(format)
+{
+    this->bounds = bounds ? *bounds : format.computeBounds(vertices);
+    this->upload(vertices, indices);
+}
+
+void VaoWrapper::upload(std::span<const std::byte> vertices, std::span<const unsigned int> indices) {
     glGenVertexArrays(1, &vao);
 
     unsigned int bufs[2]{}; 
@@ -21,42 +39,71 @@ VaoWrapper::VaoWrapper(const std::shared_ptr<std::vector<float>> vertices, const
     glBindVertexArray(vao);
 
     glBindBuffer(GL_ARRAY_BUFFER, vertexBuf);
-    glBufferData(GL_ARRAY_BUFFER, vertices->size() * sizeof(float), vertices->data(), GL_STATIC_DRAW);      //performs a copy so should be safe to clear array here
+    glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);      //performs a copy so should be safe to clear array here
                                                                                                             
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices->size() * sizeof(unsigned int), indices->data(), GL_STATIC_DRAW);
+    this->uploadIndices(indices);
 
     //set vertex attribute pointers
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void*>(0));
+    this->format.apply();
 
-    glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 }
 
 
 VaoWrapper::~VaoWrapper() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vertexBuf);
-    glDeleteBuffers(1, &indexBuf);
+    GLDeletionQueue &deletionQueue = GLDeletionQueue::global();
+    deletionQueue.deleteVertexArray(this->vao);
+    deletionQueue.deleteBuffer(this->vertexBuf);
+    deletionQueue.deleteBuffer(this->indexBuf);
 }
 
 void VaoWrapper::draw() 
 {
     glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, this->currentIndexSize, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, this->currentIndexSize, this->narrowIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
-void VaoWrapper::reBindVertexBuff() {
+const DamageRect& VaoWrapper::getBounds() const {
+    return this->bounds;
+}
+
+void VaoWrapper::reBindVertexBuff(std::span<const float> vertices) {
+    this->reBindVertexBytes(PositionVertex::Layout::format(), std::as_bytes(vertices));
+}
+
+void VaoWrapper::reBindVertexBytes(const VertexFormat &format, std::span<const std::byte> vertices) {
+    if (!format.matches(this->format)) {
+        throw std::runtime_error("Vertex format differs from the one the VAO was set up with");
+    }
+    this->bounds = this->format.computeBounds(vertices);
     glBindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, vertexBuf);
-    glBufferData(GL_ARRAY_BUFFER, vertices->size() * sizeof(float), vertices->data(), GL_STATIC_DRAW);      //performs a copy so should be safe to clear array here
+    glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);      //performs a copy so should be safe to clear array here
     glBindVertexArray(0);
 }
 
-void VaoWrapper::reBindIndexBuff() {
+void VaoWrapper::reBindIndexBuff(std::span<const unsigned int> indices) {
     glBindVertexArray(vao);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices->size() * sizeof(unsigned int), indices->data(), GL_STATIC_DRAW);
+    this->uploadIndices(indices);
     glBindVertexArray(0);
 }
+
+bool VaoWrapper::hasNarrowIndices() const {
+    return this->narrowIndices;
+}
+
+void VaoWrapper::uploadIndices(std::span<const unsigned int> indices) {
+    this->currentIndexSize = indices.size();
+
+    //half the index bandwidth whenever the indices allow it, costs one temporary copy here
+    this->narrowIndices = MeshOptimizer::fitsUnsignedShort(indices);
+    if (this->narrowIndices) {
+        std::vector<uint16_t> narrowed(indices.begin(), indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrowed.size() * sizeof(uint16_t), narrowed.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
+    }
+}
@@ -1,32 +1,69 @@
 #ifndef VAO_WRAPPER_H
 #define VAO_WRAPPER_H
 
+#include <cstddef>
 #include <vector>
-#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include "damage_rect.h"
+#include "vertex_layout.h"
 extern "C" {
 #include <cstdint>
 }
 
+//cpu side copy of a mesh, kept around by whoever wants to re-upload it later. Plain positions (PositionVertex)
+struct MeshData {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+};
+
 class VaoWrapper {
     private:
-        constexpr static uint32_t VERTEX_SIZE = 3;
-        constexpr static uint32_t VERTEX_MAX_COUNT = 6;
-        constexpr static uint32_t VERTEX_ARRAY_SIZE = VERTEX_SIZE * VERTEX_MAX_COUNT;
-        
-        std::shared_ptr<std::vector<float>> vertices;
-        std::shared_ptr<std::vector<unsigned int>> indices;
-
         unsigned int vao, vertexBuf, indexBuf;
-        unsigned int currentIndexSize, currentVertexSize;
+        unsigned int currentIndexSize;
+        bool narrowIndices;
+        VertexFormat format;
+
+        DamageRect bounds;
+        void upload(std::span<const std::byte> verts, std::span<const unsigned int> inds);
+        void reBindVertexBytes(const VertexFormat &format, std::span<const std::byte> vertices);
+        //VAO has to be bound
+        void uploadIndices(std::span<const unsigned int> indices);
 
     public:
-        VaoWrapper(const std::shared_ptr<std::vector<float>> vertices, const std::shared_ptr<std::vector<unsigned int>> indices);
+        VaoWrapper(const MeshData &mesh);
+        /** 
+         * Uploads straight from the spans without keeping them (e.g. an mmaped scene file). 
+         * Pass bounds if known to skip walking the vertices
+         * */
+        VaoWrapper(std::span<const float> vertices, std::span<const unsigned int> indices, std::optional<DamageRect> bounds = std::nullopt);
+        //same for any vertex struct with a Layout, sets up one attribute pointer per attribute in it
+        template<VertexType Vertex>
+        VaoWrapper(std::span<const Vertex> vertices, std::span<const unsigned int> indices, std::optional<DamageRect> bounds = std::nullopt) : 
+            VaoWrapper(Vertex::Layout::format(), std::as_bytes(vertices), indices, bounds) {}
+        //vertices has to be laid out as format says
+        VaoWrapper(const VertexFormat &format, std::span<const std::byte> vertices, std::span<const unsigned int> indices, 
+                std::optional<DamageRect> bounds = std::nullopt);
         ~VaoWrapper();
 
-        void reBindVertexBuff();
-        void reBindIndexBuff();
+        VaoWrapper(const VaoWrapper&) = delete;
+        VaoWrapper& operator=(const VaoWrapper&) = delete;
+
+        //replace the uploaded data, e.g. after editing the MeshData it came from. Throws if the format differs from the one it was created with
+        void reBindVertexBuff(std::span<const float> vertices);
+        template<VertexType Vertex>
+        void reBindVertexBuff(std::span<const Vertex> vertices) {
+            this->reBindVertexBytes(Vertex::Layout::format(), std::as_bytes(vertices));
+        }
+        void reBindIndexBuff(std::span<const unsigned int> indices);
         void draw();
 
+        //local space bounding box of the vertices (xy only)
+        const DamageRect& getBounds() const;
+        //indices are uploaded as GL_UNSIGNED_SHORT whenever they all fit
+        bool hasNarrowIndices() const;
+
         void setBool(const std::string &name, bool value) const;  
         void setInt(const std::string &name, int value) const;   
         void setFloat(const std::string &name, float value) const;
@@ -0,0 +1,137 @@
+#include "vertex_layout.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+namespace {
+    GLenum glType(AttribType type) {
+        switch (type) {
+            case AttribType::Float: return GL_FLOAT;
+            case AttribType::HalfFloat: return GL_HALF_FLOAT;
+            case AttribType::Byte: return GL_BYTE;
+            case AttribType::UnsignedByte: return GL_UNSIGNED_BYTE;
+            case AttribType::Short: return GL_SHORT;
+            case AttribType::UnsignedShort: return GL_UNSIGNED_SHORT;
+            case AttribType::Int: return GL_INT;
+            case AttribType::UnsignedInt: return GL_UNSIGNED_INT;
+        }
+        throw std::runtime_error("Unknown attribute type");
+    }
+
+    template<typename T>
+    T load(const std::byte *data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+}
+
+void VertexFormat::apply() const {
+    for (const auto &attribute : this->attributes) {
+        glVertexAttribPointer(attribute.location, attribute.components, glType(attribute.type), 
+                attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<GLsizei>(this->stride), reinterpret_cast<void*>(attribute.offset));
+        glVertexAttribDivisor(attribute.location, attribute.divisor);
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+DamageRect VertexFormat::computeBounds(std::span<const std::byte> vertices) const {
+    auto position = std::find_if(this->attributes.begin(), this->attributes.end(), [](const VertexAttribute &attribute) {
+        return attribute.location == 0;
+    });
+    if (position == this->attributes.end() || position->components < 2 || vertices.size() < this->stride) {
+        return {0, 0, 0, 0};
+    }
+
+    size_t componentSize = VertexLayoutUtils::typeSize(position->type);
+    auto read = [&](size_t vertex, size_t component) {
+        return VertexLayoutUtils::readComponent(vertices.data() + vertex * this->stride + position->offset + component * componentSize, 
+                position->type, position->normalized);
+    };
+
+    DamageRect bounds = {read(0, 0), read(0, 1), read(0, 0), read(0, 1)};
+    size_t count = vertices.size() / this->stride;
+    for (size_t i = 1; i < count; i++) {
+        float x = read(i, 0), y = read(i, 1);
+        bounds.minX = std::min(bounds.minX, x), bounds.maxX = std::max(bounds.maxX, x);
+        bounds.minY = std::min(bounds.minY, y), bounds.maxY = std::max(bounds.maxY, y);
+    }
+    return bounds;
+}
+
+bool VertexFormat::matches(const VertexFormat &other) const {
+    return this->stride == other.stride && std::equal(this->attributes.begin(), this->attributes.end(), 
+            other.attributes.begin(), other.attributes.end());
+}
+
+float VertexLayoutUtils::halfToFloat(Half value) {
+    uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000) << 16;
+    uint32_t exponent = (value.bits >> 10) & 0x1F;
+    uint32_t mantissa = value.bits & 0x3FF;
+
+    if (exponent == 0) {
+        //zero or subnormal, scale it by hand
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1F) {
+        return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+float VertexLayoutUtils::readComponent(const std::byte *data, AttribType type, bool normalized) {
+    switch (type) {
+        case AttribType::Float: 
+            return load<float>(data);
+        case AttribType::HalfFloat: 
+            return halfToFloat(load<Half>(data));
+        //signed normalization as GL 4.2+ does it, -128 and -32768 clamp to -1
+        case AttribType::Byte: {
+            float value = load<int8_t>(data);
+            return normalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case AttribType::UnsignedByte: {
+            float value = load<uint8_t>(data);
+            return normalized ? value / 255.0f : value;
+        }
+        case AttribType::Short: {
+            float value = load<int16_t>(data);
+            return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+        }
+        case AttribType::UnsignedShort: {
+            float value = load<uint16_t>(data);
+            return normalized ? value / 65535.0f : value;
+        }
+        case AttribType::Int: {
+            double value = load<int32_t>(data);
+            return static_cast<float>(normalized ? std::max(value / 2147483647.0, -1.0) : value);
+        }
+        case AttribType::UnsignedInt: {
+            double value = load<uint32_t>(data);
+            return static_cast<float>(normalized ? value / 4294967295.0 : value);
+        }
+    }
+    return 0.0f;
+}
+
+size_t VertexLayoutUtils::typeSize(AttribType type) {
+    switch (type) {
+        case AttribType::Float: case AttribType::Int: case AttribType::UnsignedInt: 
+            return 4;
+        case AttribType::HalfFloat: case AttribType::Short: case AttribType::UnsignedShort: 
+            return 2;
+        case AttribType::Byte: case AttribType::UnsignedByte: 
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "damage_rect.h"
+
+//16 bit float as it sits in a vertex buffer (GL_HALF_FLOAT)
+struct Half {
+    uint16_t bits;
+};
+
+enum class AttribType : uint8_t {
+    Float,
+    HalfFloat,
+    Byte,
+    UnsignedByte,
+    Short,
+    UnsignedShort,
+    Int,
+    UnsignedInt
+};
+
+template<typename T> struct AttribTypeOf;
+template<> struct AttribTypeOf<float> { static constexpr AttribType value = AttribType::Float; };
+template<> struct AttribTypeOf<Half> { static constexpr AttribType value = AttribType::HalfFloat; };
+template<> struct AttribTypeOf<int8_t> { static constexpr AttribType value = AttribType::Byte; };
+template<> struct AttribTypeOf<uint8_t> { static constexpr AttribType value = AttribType::UnsignedByte; };
+template<> struct AttribTypeOf<int16_t> { static constexpr AttribType value = AttribType::Short; };
+template<> struct AttribTypeOf<uint16_t> { static constexpr AttribType value = AttribType::UnsignedShort; };
+template<> struct AttribTypeOf<int32_t> { static constexpr AttribType value = AttribType::Int; };
+template<> struct AttribTypeOf<uint32_t> { static constexpr AttribType value = AttribType::UnsignedInt; };
+
+struct VertexAttribute {
+    unsigned int location;
+    int components;
+    AttribType type;
+    bool normalized;        //integer types only, maps to [0, 1] / [-1, 1] instead of converting the value as is
+    unsigned int divisor;   //0 per vertex, n advances once every n instances
+    size_t offset;
+
+    bool operator==(const VertexAttribute&) const = default;
+};
+
+/** 
+ * Runtime view of a VertexLayout, what the GL side needs to set up attribute pointers. 
+ * Attributes always end up as floats in the shader (no glVertexAttribIPointer)
+ * */
+struct VertexFormat {
+    size_t stride;
+    std::span<const VertexAttribute> attributes;
+
+    //for the bound VAO, sources the attributes from whatever is bound to GL_ARRAY_BUFFER
+    void apply() const;
+    //xy bounds of the attribute at location 0 (the position by convention)
+    DamageRect computeBounds(std::span<const std::byte> vertices) const;
+    bool matches(const VertexFormat &other) const;
+};
+
+//one attribute of a VertexLayout, Component is the C++ type of each component (float, Half, uint8_t, ...)
+template<unsigned int Location, typename Component, int Components, bool Normalized = false, unsigned int Divisor = 0>
+struct Attribute {
+    static_assert(Components >= 1 && Components <= 4, "Attributes have 1 to 4 components");
+    static_assert(!Normalized || (!std::is_same_v<Component, float> && !std::is_same_v<Component, Half>), 
+            "Only integer attributes can be normalized");
+
+    static constexpr size_t SIZE = sizeof(Component) * Components;
+
+    static constexpr VertexAttribute describe(size_t offset) {
+        return {Location, Components, AttribTypeOf<Component>::value, Normalized, Divisor, offset};
+    }
+};
+
+/** 
+ * Attributes laid out back to back in the given order, no padding. The vertex struct using it has to match that exactly,
+ * VaoWrapper checks the size. Offsets and stride are worked out at compile time
+ * */
+template<typename... Attributes>
+struct VertexLayout {
+    static constexpr size_t STRIDE = (Attributes::SIZE + ...);
+
+    static constexpr std::array<VertexAttribute, sizeof...(Attributes)> ATTRIBUTES = [] {
+        std::array<VertexAttribute, sizeof...(Attributes)> attributes{};
+        size_t offset = 0, i = 0;
+        ((attributes[i++] = Attributes::describe(offset), offset += Attributes::SIZE), ...);
+        return attributes;
+    }();
+
+    static constexpr VertexFormat format() {
+        return {STRIDE, ATTRIBUTES};
+    }
+};
+
+//a struct with a Layout that describes it byte for byte
+template<typename V>
+concept VertexType = requires { typename V::Layout; } && sizeof(V) == V::Layout::STRIDE;
+
+//what VaoWrapper used to hardcode, plain vec3 positions
+struct PositionVertex {
+    float x, y, z;
+
+    using Layout = VertexLayout<Attribute<0, float, 3>>;
+};
+
+namespace VertexLayoutUtils {
+    float halfToFloat(Half value);
+    //one component as the shader would see it
+    float readComponent(const std::byte *data, AttribType type, bool normalized);
+    size_t typeSize(AttribType type);
+}
+
+#endif
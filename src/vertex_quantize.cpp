@@ -0,0 +1,143 @@
+#include "vertex_quantize.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace {
+    constexpr float HALF_MAX = 65504.0f;
+
+    //quantizes one component and keeps score of how far off it decodes
+    struct ErrorTracker {
+        QuantizationReport &report;
+        double positionErrorSum = 0.0;
+        size_t positionCount = 0;
+
+        template<typename T>
+        void position(T &out, float value, T encoded, AttribType type, bool normalized, bool clamped) {
+            out = encoded;
+            float error = std::abs(VertexLayoutUtils::readComponent(reinterpret_cast<const std::byte*>(&out), type, normalized) - value);
+            this->report.maxPositionError = std::max(this->report.maxPositionError, error);
+            this->positionErrorSum += error;
+            this->positionCount++;
+            this->report.clampedCount += clamped;
+        }
+
+        void color(uint8_t &out, float value) {
+            out = VertexQuantize::toUnorm8(value);
+            float error = std::abs(out / 255.0f - value);
+            this->report.maxColorError = std::max(this->report.maxColorError, error);
+            this->report.clampedCount += value < 0.0f || value > 1.0f;
+        }
+
+        void finish() {
+            this->report.meanPositionError = this->positionCount > 0 ? this->positionErrorSum / this->positionCount : 0.0;
+        }
+    };
+
+    void halfPosition(ErrorTracker &tracker, Half &out, float value) {
+        float clampedValue = std::clamp(value, -HALF_MAX, HALF_MAX);
+        tracker.position(out, value, VertexQuantize::toHalf(clampedValue), AttribType::HalfFloat, false, clampedValue != value);
+    }
+
+    size_t checkPositions(std::span<const float> positions) {
+        if (positions.size() % 3 != 0) {
+            throw std::runtime_error(std::format("Expected xyz positions, got {} floats", positions.size()));
+        }
+        return positions.size() / 3;
+    }
+}
+
+Half VertexQuantize::toHalf(float value) {
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    //inf and nan (keeping nan a nan)
+    if (magnitude >= 0x7F800000) {
+        return {static_cast<uint16_t>(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0))};
+    }
+    //65520 and up round past the largest half
+    if (magnitude >= 0x477FF000) {
+        return {static_cast<uint16_t>(sign | 0x7C00)};
+    }
+    //below the smallest normal half, the mantissa is just value * 2^24 (nearbyint rounds to even)
+    if (magnitude < 0x38800000) {
+        float scaled = std::bit_cast<float>(magnitude) * 16777216.0f;
+        return {static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(scaled)))};
+    }
+
+    //rebias the exponent and round the dropped 13 mantissa bits to even, a carry rolls into the exponent on its own
+    uint32_t rebiased = magnitude - 0x38000000;
+    uint32_t rounded = rebiased + 0xFFF + ((rebiased >> 13) & 1);
+    return {static_cast<uint16_t>(sign | (rounded >> 13))};
+}
+
+int16_t VertexQuantize::toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint8_t VertexQuantize::toUnorm8(float value) {
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+QuantizedMesh<HalfPositionVertex> VertexQuantize::toHalfPositions(std::span<const float> positions) {
+    size_t count = checkPositions(positions);
+    QuantizedMesh<HalfPositionVertex> mesh{std::vector<HalfPositionVertex>(count), {count, 0, 0, 0, 0, positions.size_bytes(), 0}};
+    ErrorTracker tracker{mesh.report};
+    for (size_t i = 0; i < count; i++) {
+        auto &vertex = mesh.vertices[i];
+        halfPosition(tracker, vertex.x, positions[i * 3]);
+        halfPosition(tracker, vertex.y, positions[i * 3 + 1]);
+        halfPosition(tracker, vertex.z, positions[i * 3 + 2]);
+        vertex.w = toHalf(1.0f);
+    }
+    tracker.finish();
+    mesh.report.bytesAfter = mesh.vertices.size() * sizeof(HalfPositionVertex);
+    return mesh;
+}
+
+QuantizedMesh<Snorm16PositionVertex> VertexQuantize::toSnorm16Positions(std::span<const float> positions) {
+    size_t count = checkPositions(positions);
+    QuantizedMesh<Snorm16PositionVertex> mesh{std::vector<Snorm16PositionVertex>(count), {count, 0, 0, 0, 0, positions.size_bytes(), 0}};
+    ErrorTracker tracker{mesh.report};
+    for (size_t i = 0; i < count; i++) {
+        auto &vertex = mesh.vertices[i];
+        int16_t *components[3] = {&vertex.x, &vertex.y, &vertex.z};
+        for (int c = 0; c < 3; c++) {
+            float value = positions[i * 3 + c];
+            tracker.position(*components[c], value, toSnorm16(value), AttribType::Short, true, value < -1.0f || value > 1.0f);
+        }
+        vertex.w = toSnorm16(1.0f);
+    }
+    tracker.finish();
+    mesh.report.bytesAfter = mesh.vertices.size() * sizeof(Snorm16PositionVertex);
+    return mesh;
+}
+
+QuantizedMesh<HalfRgba8Vertex> VertexQuantize::toHalfRgba8(std::span<const float> positions, std::span<const float> colors) {
+    size_t count = checkPositions(positions);
+    if (colors.size() != count * 4) {
+        throw std::runtime_error(std::format("Expected {} rgba colors, got {} floats", count, colors.size()));
+    }
+
+    QuantizedMesh<HalfRgba8Vertex> mesh{std::vector<HalfRgba8Vertex>(count), 
+            {count, 0, 0, 0, 0, count * sizeof(ColorVertex), 0}};
+    ErrorTracker tracker{mesh.report};
+    for (size_t i = 0; i < count; i++) {
+        auto &vertex = mesh.vertices[i];
+        halfPosition(tracker, vertex.x, positions[i * 3]);
+        halfPosition(tracker, vertex.y, positions[i * 3 + 1]);
+        halfPosition(tracker, vertex.z, positions[i * 3 + 2]);
+        vertex.w = toHalf(1.0f);
+        tracker.color(vertex.r, colors[i * 4]);
+        tracker.color(vertex.g, colors[i * 4 + 1]);
+        tracker.color(vertex.b, colors[i * 4 + 2]);
+        tracker.color(vertex.a, colors[i * 4 + 3]);
+    }
+    tracker.finish();
+    mesh.report.bytesAfter = mesh.vertices.size() * sizeof(HalfRgba8Vertex);
+    return mesh;
+}
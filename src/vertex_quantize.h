@@ -0,0 +1,69 @@
+#ifndef VERTEX_QUANTIZE_H
+#define VERTEX_QUANTIZE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "vertex_layout.h"
+
+//positions as half floats, w is always 1 and only there to keep vertices 4 byte aligned. Exact to ~1/2048 of the magnitude
+struct HalfPositionVertex {
+    Half x, y, z, w;
+
+    using Layout = VertexLayout<Attribute<0, Half, 4>>;
+};
+
+//positions as normalized shorts, has to be within [-1, 1] (GL screenspace). Exact to ~1/32767
+struct Snorm16PositionVertex {
+    int16_t x, y, z, w;
+
+    using Layout = VertexLayout<Attribute<0, int16_t, 4, true>>;
+};
+
+//full precision reference for HalfRgba8Vertex, 28 bytes
+struct ColorVertex {
+    float x, y, z;
+    float r, g, b, a;
+
+    using Layout = VertexLayout<Attribute<0, float, 3>, Attribute<1, float, 4>>;
+};
+
+//half positions plus an RGBA8 color at location 1, 12 bytes
+struct HalfRgba8Vertex {
+    Half x, y, z, w;
+    uint8_t r, g, b, a;
+
+    using Layout = VertexLayout<Attribute<0, Half, 4>, Attribute<1, uint8_t, 4, true>>;
+};
+
+//how far the packed values are off from the originals, measured by decoding them the way GL does
+struct QuantizationReport {
+    size_t vertexCount;
+    float maxPositionError;
+    double meanPositionError;
+    float maxColorError;
+    //components outside of what the format can represent, stored clamped
+    size_t clampedCount;
+    size_t bytesBefore, bytesAfter;
+};
+
+template<typename Vertex>
+struct QuantizedMesh {
+    std::vector<Vertex> vertices;
+    QuantizationReport report;
+};
+
+namespace VertexQuantize {
+    //round to nearest even, out of range values turn into infinity like a GPU conversion would
+    Half toHalf(float value);
+    int16_t toSnorm16(float value);
+    uint8_t toUnorm8(float value);
+
+    //positions are xyz floats, colors rgba floats in [0, 1] (one per vertex)
+    QuantizedMesh<HalfPositionVertex> toHalfPositions(std::span<const float> positions);
+    QuantizedMesh<Snorm16PositionVertex> toSnorm16Positions(std::span<const float> positions);
+    QuantizedMesh<HalfRgba8Vertex> toHalfRgba8(std::span<const float> positions, std::span<const float> colors);
+}
+
+#endif
@@ -0,0 +1,153 @@
+/** 
+ * Fails if a steady state frame allocates. Renders a representative frame (input queue, simulation tick, squares moving
+ * with partial redraw where buffer age is available, uniform setters, arena formatting) into a hidden window and arms the allocation counter after warm-up.
+ *
+ * Usage: AllocationCheck [frames (default 600)] [warm-up frames (default 10)]
+ *
+ * Needs a build with -DGLTEMPLATE_COUNT_ALLOCATIONS=ON. Exits 1 and prints the call stacks of the first offenders
+ * if anything called operator new while armed.
+ * */
+#include "allocation_counter.h"
+#include "buffer_age.h"
+#include "damage_tracker.h"
+#include "example_world.h"
+#include "frame_arena.h"
+#include "gameboard_utils.h"
+#include "gl_deletion_queue.h"
+#include "gl_resources.h"
+#include "hidden_context.h"
+#include "input_queue.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "square.h"
+#include "vao_wrapper.h"
+
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+namespace {
+    constexpr int WIDTH = 256;
+    constexpr int HEIGHT = 256;
+}
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    int warmup = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    if (!AllocationCounter::isEnabled()) {
+        std::cerr << "AllocationCheck: needs a build with -DGLTEMPLATE_COUNT_ALLOCATIONS=ON\n";
+        return 1;
+    }
+
+    uint64_t offenders = 0;
+    try {
+        GLFWwindow *window = HiddenContext::create(WIDTH, HEIGHT, "AllocationCheck");
+        {
+            ShaderDefines defines = {
+                {"BOARD_SIZE_X", std::to_string(GameBoardUtils::BOARDSIZE.x)},
+                {"BOARD_SIZE_Y", std::to_string(GameBoardUtils::BOARDSIZE.y)},
+                {"BOARD_SIZE_Z", std::to_string(GameBoardUtils::BOARDSIZE.z)}
+            };
+            GLResources resources;
+            ShaderPreprocessor preprocessor;
+            auto vert = preprocessor.process("shader.vert", defines);
+            auto frag = preprocessor.process("shader.frag", defines);
+            auto shader = resources.getShaders().create(ShaderSource{vert.source, frag.source});
+
+            auto vao = resources.getVaos().create(MeshData{
+                {0.5f, 0.5f, 0.0f,  0.5f, -0.5f, 0.0f,  -0.5f, -0.5f, 0.0f,  -0.5f, 0.5f, 0.0f},
+                {0, 1, 3, 1, 2, 3}
+            });
+
+            auto damageTracker = std::make_shared<DamageTracker>(BufferAge::isSupported() ? 
+                    DamageTracker::RedrawMode::OnDemandPartial : DamageTracker::RedrawMode::OnDemand);
+            ExampleWorld world;
+            Square squareOne(resources, vao, shader, {1.0f, 0.4f, 0.1f}, GameBoardUtils::translateBoardCoordsToGL(world.getSquareOnePos()));
+            Square squareTwo(resources, vao, shader, {0.1f, 0.2f, 0.1f}, GameBoardUtils::translateBoardCoordsToGL(world.getSquareTwoPos()));
+            squareOne.setDamageTracker(damageTracker);
+            squareTwo.setDamageTracker(damageTracker);
+            std::array<Square*, 2> squares = {&squareOne, &squareTwo};
+
+            auto inputQueue = std::make_unique<InputQueue>();
+            std::vector<InputEvent> inputEvents;
+            FrameArena &frameArena = FrameArena::local();
+            uint64_t checksum = 0;
+
+            for (int frame = 0; frame < frames; frame++) {
+                if (frame == warmup) {
+                    AllocationCounter::arm();
+                }
+                frameArena.reset();
+
+                //a key press every few frames so the input path and the squares moving are part of the frame
+                if (frame % 8 == 0) {
+                    int action = frame % 16 == 0 ? GLFW_PRESS : GLFW_RELEASE;
+                    inputQueue->push(InputEvent{InputEvent::Type::Key, GLFW_KEY_RIGHT, action, 0, 0, 0, glfwGetTime()});
+                }
+                inputQueue->drain(inputEvents);
+                world.step(frame, inputEvents);
+                inputEvents.clear();
+
+                squareOne.setPos(GameBoardUtils::translateBoardCoordsToGL(world.getSquareOnePos()));
+                squareTwo.setPos(GameBoardUtils::translateBoardCoordsToGL(world.getSquareTwoPos()));
+                checksum += GameBoardUtils::posToString(world.getSquareOnePos(), &frameArena).size();
+
+                damageTracker->setBufferAge(BufferAge::query());
+                const auto &redrawRects = damageTracker->beginRedraw(WIDTH, HEIGHT);
+                glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+                if (redrawRects.empty()) {
+                    glClear(GL_COLOR_BUFFER_BIT);
+                    for (auto square : squares) {
+                        square->draw();
+                    }
+                } else {
+                    glEnable(GL_SCISSOR_TEST);
+                    for (const auto &rect : redrawRects) {
+                        glScissor(rect.x, rect.y, rect.width, rect.height);
+                        glClear(GL_COLOR_BUFFER_BIT);
+                        for (auto square : squares) {
+                            if (square->getBounds().intersects(rect.screenRect)) {
+                                square->draw();
+                            }
+                        }
+                    }
+                    glDisable(GL_SCISSOR_TEST);
+                }
+                glfwSwapBuffers(window);
+                damageTracker->endRedraw();
+                resources.collect();
+                GLDeletionQueue::global().endFrame();
+                glfwPollEvents();
+            }
+            AllocationCounter::disarm();
+            offenders = AllocationCounter::getArmedCount();
+
+            std::cout << std::format("{} frames ({} warm-up), {} allocations after warm-up, arena high water {} bytes (checksum {})\n",
+                    frames, warmup, offenders, frameArena.getHighWaterBytes(), checksum);
+            resources.destroyAll();
+            GLDeletionQueue::global().flush();
+        }
+        glfwTerminate();
+    } catch (const std::exception &e) {
+        AllocationCounter::disarm();
+        std::cerr << std::format("AllocationCheck: {}\n", e.what());
+        return 1;
+    }
+
+    if (offenders > 0) {
+        AllocationCounter::printOffenders();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/** 
+ * Save/load benchmark for board files.
+ *
+ * Usage: BoardBench [cells per side (default 4096)] [depth (default 16)] [path (default board_bench.gltb)]
+ *
+ * Default is 4096x4096x16 cells, 1GiB on disk. "first frame" is reading the visible 
+ * BOARDSIZE window, which is all the renderer touches before it can present.
+ * */
+#include "game_board.h"
+#include "gameboard_utils.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char **argv) {
+    int side = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int depth = argc > 2 ? std::atoi(argv[2]) : 16;
+    std::filesystem::path path = argc > 3 ? argv[3] : "board_bench.gltb";
+
+    try {
+        GameBoardPos size{side, side, depth};
+        double gib = static_cast<double>(side) * side * depth * sizeof(BoardCell) / (1 << 30);
+        std::cout << std::format("board {}x{}x{} ({:.3f} GiB)\n", side, side, depth, gib);
+
+        {
+            GameBoard board(size);
+            auto cells = board.getCells();
+            for (size_t i = 0; i < cells.size(); i++) {
+                cells[i] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i >> 16), 1};
+            }
+
+            auto start = Clock::now();
+            board.save(path);
+            std::cout << std::format("save (incl. fsync):   {:>10.3f}ms\n", msSince(start));
+        }
+
+        auto start = Clock::now();
+        GameBoard loaded(path);
+        std::cout << std::format("load:                 {:>10.3f}ms\n", msSince(start));
+
+        start = Clock::now();
+        uint64_t sum = 0;
+        auto &visible = GameBoardUtils::BOARDSIZE;
+        for (int y = 0; y < visible.y && y < side; y++) {
+            for (int x = 0; x < visible.x && x < side; x++) {
+                sum += loaded.get({x, y, 0}).r;
+            }
+        }
+        std::cout << std::format("first frame (visible):{:>10.3f}ms\n", msSince(start));
+
+        start = Clock::now();
+        loaded.set({side - 1, side - 1, depth - 1}, {255, 255, 255, 2});
+        std::cout << std::format("first edit (cow):     {:>10.3f}ms\n", msSince(start));
+
+        start = Clock::now();
+        for (int z = 0; z < depth; z++) {
+            for (int y = 0; y < side; y++) {
+                sum += loaded.get({0, y, z}).g;
+            }
+        }
+        std::cout << std::format("touch every chunk:    {:>10.3f}ms (checksum {})\n", msSince(start), sum);
+
+        std::filesystem::remove(path);
+    } catch (const std::exception &e) {
+        std::cerr << std::format("BoardBench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
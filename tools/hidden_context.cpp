@@ -0,0 +1,36 @@
+#include "hidden_context.h"
+#include "gl_loader.h"
+
+#include <stdexcept>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+}
+
+namespace HiddenContext {
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    GLFWwindow* create(int width, int height, const char *title) {
+        if (!glfwInit()) {
+            throw std::runtime_error("Failed to initialize glfw");
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        GLFWwindow *window = glfwCreateWindow(width, height, title, NULL, NULL);
+        if (window == NULL) {
+            glfwTerminate();
+            throw std::runtime_error("Failed to create a window");
+        }
+        glfwMakeContextCurrent(window);
+        if (!GLLoader::load(GLLoader::Mode::Full)) {
+            glfwTerminate();
+            throw std::runtime_error("Failed to load glad");
+        }
+        return window;
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef HIDDEN_CONTEXT_H
+#define HIDDEN_CONTEXT_H
+
+#include <chrono>
+
+struct GLFWwindow;
+
+//shared by the tools that need a GL context but nothing on screen
+namespace HiddenContext {
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start);
+
+    //inits glfw, creates an invisible window with a current 3.3 core context and loads all of GL. Throws on failure
+    GLFWwindow* create(int width, int height, const char *title);
+}
+
+#endif
@@ -0,0 +1,54 @@
+/** 
+ * Headless replay of a recorded input log against the example simulation, as fast as it will go.
+ *
+ * Usage: InputReplay <log> [--verify]
+ *
+ * Record one with GLTEMPLATE_RECORD_INPUT=path. --verify compares the world hash with the recorded one 
+ * every hash interval and stops at the first tick that diverged.
+ * */
+#include "example_world.h"
+#include "input_log.h"
+
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: InputReplay <log> [--verify]\n";
+        return 1;
+    }
+    bool verify = argc > 2 && std::strcmp(argv[2], "--verify") == 0;
+
+    try {
+        InputReplayer replayer(argv[1]);
+        if (replayer.getTickRate() != ExampleWorld::TICK_RATE) {
+            std::cerr << std::format("InputReplay: log was recorded at {} ticks/s, the simulation runs at {}\n", 
+                    replayer.getTickRate(), ExampleWorld::TICK_RATE);
+            return 1;
+        }
+
+        ExampleWorld world;
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t tick = 0; tick < replayer.getTickCount(); tick++) {
+            world.step(tick, replayer.eventsFor(tick));
+            if (verify && !replayer.verify(tick, world.hash())) {
+                std::cerr << std::format("InputReplay: diverged at tick {}\n", tick);
+                return 2;
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::format("replayed {} ticks ({:.1f}s of play) in {:.3f}ms\n", 
+                replayer.getTickCount(), static_cast<double>(replayer.getTickCount()) / replayer.getTickRate(), ms);
+        if (verify) {
+            std::cout << std::format("{} hashes matched\n", replayer.getVerifiedCount());
+        }
+        std::cout << std::format("final world hash {:016x}\n", world.hash());
+    } catch (const std::exception &e) {
+        std::cerr << std::format("InputReplay: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
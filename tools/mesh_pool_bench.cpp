@@ -0,0 +1,145 @@
+/**
+ * Draws many small meshes once as separate VaoWrappers and once out of a MeshPool, then churns the pool
+ * (removing and adding meshes of random sizes) and compacts it, printing the pool stats along the way.
+ *
+ * Usage: MeshPoolBench [meshes (default 10000)] [churn rounds (default 20)]
+ *
+ * Renders into a hidden window, draw times include a glFinish.
+ * */
+#include "gl_deletion_queue.h"
+#include "gl_resources.h"
+#include "hidden_context.h"
+#include "mesh_pool.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "vao_wrapper.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+namespace {
+    using HiddenContext::Clock;
+    using HiddenContext::msSince;
+
+    //triangle fan of sides + 1 vertices around the origin
+    MeshData makePolygon(int sides, float radius) {
+        MeshData mesh;
+        mesh.vertices.insert(mesh.vertices.end(), {0.0f, 0.0f, 0.0f});
+        for (int i = 0; i < sides; i++) {
+            float angle = 6.2831853f * i / sides;
+            mesh.vertices.insert(mesh.vertices.end(), {radius * std::cos(angle), radius * std::sin(angle), 0.0f});
+            mesh.indices.insert(mesh.indices.end(), {0u, static_cast<unsigned int>(i + 1), static_cast<unsigned int>((i + 1) % sides + 1)});
+        }
+        return mesh;
+    }
+
+    void printStats(const char *label, const MeshPool::Stats &stats) {
+        std::cout << std::format("{}: {} meshes, vertices {}/{} ({:.1f}%, {} free ranges, {:.2f} fragmented), "
+                "indices {}/{} ({:.1f}%, {} free ranges, {:.2f} fragmented), {} relocations\n",
+                label, stats.meshCount,
+                stats.vertexUsed, stats.vertexCapacity, 100.0 * stats.vertexUsed / stats.vertexCapacity, stats.vertexFreeRanges, stats.vertexFragmentation,
+                stats.indexUsed, stats.indexCapacity, 100.0 * stats.indexUsed / stats.indexCapacity, stats.indexFreeRanges, stats.indexFragmentation,
+                stats.relocations);
+    }
+}
+
+int main(int argc, char **argv) {
+    int meshCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int churnRounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    try {
+        HiddenContext::create(256, 256, "MeshPoolBench");
+        {
+            std::mt19937 rng(1234);
+            std::uniform_int_distribution<int> sides(3, 12);
+            std::vector<MeshData> meshes;
+            for (int i = 0; i < meshCount; i++) {
+                meshes.push_back(makePolygon(sides(rng), 0.01f));
+            }
+
+            GLResources resources;
+            auto start = Clock::now();
+            std::vector<VaoHandle> vaos;
+            for (const auto &mesh : meshes) {
+                vaos.push_back(resources.getVaos().create(mesh));
+            }
+            double vaoCreateMs = msSince(start);
+
+            start = Clock::now();
+            MeshPool pool(1024, 4096);
+            std::vector<MeshPool::MeshHandle> pooled;
+            for (const auto &mesh : meshes) {
+                pooled.push_back(pool.add(mesh.vertices, mesh.indices));
+            }
+            double poolCreateMs = msSince(start);
+
+            //both loops draw with the same program, bound outside the timed part
+            ShaderVariantCache shaders(resources);
+            Shader &shader = resources.get(shaders.get("shader.vert", "shader.frag"));
+            shader.bind();
+            shader.set3f("color", {1.0f, 1.0f, 1.0f});
+            shader.set3f("offset", {0.0f, 0.0f, 0.0f});
+
+            glFinish();
+            start = Clock::now();
+            for (auto vao : vaos) {
+                resources.get(vao).draw();
+            }
+            glFinish();
+            double vaoDrawMs = msSince(start);
+
+            start = Clock::now();
+            pool.bind();
+            for (auto mesh : pooled) {
+                pool.draw(mesh);
+            }
+            pool.unbind();
+            glFinish();
+            double poolDrawMs = msSince(start);
+
+            std::cout << std::format("{} meshes, {} GL objects as VaoWrappers vs 3 pooled\n", meshCount, meshCount * 3);
+            std::cout << std::format("create: VaoWrapper {:.2f}ms, MeshPool {:.2f}ms\n", vaoCreateMs, poolCreateMs);
+            std::cout << std::format("draw:   VaoWrapper {:.2f}ms, MeshPool {:.2f}ms\n", vaoDrawMs, poolDrawMs);
+            printStats("filled", pool.getStats());
+
+            //remove a random third each round and add back meshes of different sizes
+            for (int round = 0; round < churnRounds; round++) {
+                for (size_t i = 0; i < pooled.size(); i++) {
+                    if (rng() % 3 == 0) {
+                        pool.remove(pooled[i]);
+                        const auto &mesh = meshes[rng() % meshes.size()];
+                        pooled[i] = pool.add(mesh.vertices, mesh.indices);
+                    }
+                }
+            }
+            printStats("churned", pool.getStats());
+
+            start = Clock::now();
+            pool.defragment();
+            glFinish();
+            double defragMs = msSince(start);
+            printStats("defragmented", pool.getStats());
+            std::cout << std::format("defragment: {:.2f}ms\n", defragMs);
+
+            resources.destroyAll();
+        }
+        GLDeletionQueue::global().flush();
+        glfwTerminate();
+    } catch (const std::exception &e) {
+        std::cerr << std::format("MeshPoolBench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/** 
+ * Append/seek benchmark for the rewind buffer.
+ *
+ * Usage: RewindBench [cells per side (default 512)] [depth (default 16)] [edits per tick (default 1000)] [MiB budget (default 256)]
+ *
+ * Simulates 60 ticks/s with random cell edits and a small entity array, keeps the last 10 seconds.
+ * */
+#include "rewind_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t TICK_RATE = 60;
+    constexpr uint32_t SECONDS = 10;
+
+    struct Entity {
+        float x, y, z;
+        uint32_t state;
+    };
+
+    double usSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char **argv) {
+    int side = argc > 1 ? std::atoi(argv[1]) : 512;
+    int depth = argc > 2 ? std::atoi(argv[2]) : 16;
+    int edits = argc > 3 ? std::atoi(argv[3]) : 1000;
+    size_t budget = (argc > 4 ? std::atoll(argv[4]) : 256) << 20;
+
+    std::vector<BoardCell> cells(static_cast<size_t>(side) * side * depth, BoardCell{0, 0, 0, 0});
+    std::vector<Entity> entities(256, Entity{0, 0, 0, 0});
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> cellDist(0, cells.size() - 1);
+
+    RewindBuffer rewind(TICK_RATE * SECONDS, budget);
+    std::cout << std::format("board {}x{}x{} ({:.1f} MiB), {} edits/tick\n", side, side, depth, cells.size() * sizeof(BoardCell) / 1048576.0, edits);
+
+    uint64_t ticks = TICK_RATE * SECONDS * 2;
+    double total = 0, worst = 0;
+    for (uint64_t tick = 0; tick < ticks; tick++) {
+        for (int i = 0; i < edits; i++) {
+            cells[cellDist(rng)] = {static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), 1};
+        }
+        for (auto &entity : entities) {
+            entity.x += 0.1f;
+            entity.state = static_cast<uint32_t>(tick);
+        }
+
+        auto start = Clock::now();
+        rewind.push(tick, cells, std::as_bytes(std::span(entities)));
+        double us = usSince(start);
+        total += us;
+        worst = std::max(worst, us);
+    }
+    std::cout << std::format("append: mean {:.1f}us, max {:.1f}us\n", total / ticks, worst);
+    std::cout << std::format("held {} ticks ({} -> {}), {:.2f} MiB stored\n", 
+        rewind.getFrameCount(), rewind.getOldestTick(), rewind.getNewestTick(), rewind.getStoredBytes() / 1048576.0);
+
+    std::vector<BoardCell> restored(cells.size());
+    std::vector<std::byte> restoredEntities;
+    for (double seconds : {0.0, 1.0, 5.0, 9.9}) {
+        uint64_t tick = rewind.getNewestTick() - static_cast<uint64_t>(seconds * TICK_RATE);
+        auto start = Clock::now();
+        bool found = rewind.seek(tick, restored, restoredEntities);
+        std::cout << std::format("seek -{:.1f}s: {:.1f}us{}\n", seconds, usSince(start), found ? "" : " (not held)");
+    }
+
+    if (!rewind.seek(rewind.getNewestTick(), restored, restoredEntities) || std::memcmp(restored.data(), cells.data(), cells.size() * sizeof(BoardCell)) != 0) {
+        std::cerr << "RewindBench: newest tick didnt round trip\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * Converts a text scene description into the mmapable binary format read by SceneFile.
+ *
+ * Usage: ScenePacker [--positions float|half|snorm16] [--optimize] <scene.txt> <scene.glts>
+ *
+ * half and snorm16 store the positions packed (8 instead of 12 bytes per vertex) and print how far off they end up,
+ * snorm16 only works for positions within [-1, 1]. --optimize reorders triangles for the vertex cache and vertices
+ * for fetch locality, and prints the ACMR before and after.
+ *
+ * One entry per line, # starts a comment:
+ *   v <x> <y> <z>                  vertex
+ *   f <a> <b> <c>                  triangle, zero based vertex indices
+ *   inst <x> <y> <z> <r> <g> <b>   instance, color channels 0-255
+ * */
+#include "scene_file.h"
+#include "damage_rect.h"
+#include "vertex_quantize.h"
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    std::string_view nextToken(std::string_view &line) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos) {
+            line = {};
+            return {};
+        }
+        size_t end = line.find_first_of(" \t\r", start);
+        auto token = line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        line = end == std::string_view::npos ? std::string_view() : line.substr(end);
+        return token;
+    }
+
+    template<typename T>
+    T parseNumber(std::string_view &line, size_t lineNumber) {
+        auto token = nextToken(line);
+        T value{};
+        auto [ptr, err] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || err != std::errc() || ptr != token.data() + token.size()) {
+            throw std::runtime_error(std::format("line {}: expected a number, got \"{}\"", lineNumber, token));
+        }
+        return value;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string_view positionFormat = "float";
+    bool optimize = false;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--positions" && i + 1 < argc) {
+            positionFormat = argv[++i];
+        } else if (arg == "--optimize") {
+            optimize = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2 || (positionFormat != "float" && positionFormat != "half" && positionFormat != "snorm16")) {
+        std::cerr << "Usage: ScenePacker [--positions float|half|snorm16] [--optimize] <scene.txt> <scene.glts>\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        std::ifstream input(paths[0]);
+        if (!input.is_open()) {
+            throw std::runtime_error(std::format("File: {} failed to open", paths[0]));
+        }
+
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<SceneFormat::SceneInstance> instances;
+
+        std::string rawLine;
+        size_t lineNumber = 0;
+        while (std::getline(input, rawLine)) {
+            lineNumber++;
+            std::string_view line = rawLine;
+            line = line.substr(0, line.find('#'));
+
+            auto kind = nextToken(line);
+            if (kind.empty()) {
+                continue;
+            } else if (kind == "v") {
+                for (int i = 0; i < 3; i++) {
+                    vertices.push_back(parseNumber<float>(line, lineNumber));
+                }
+            } else if (kind == "f") {
+                for (int i = 0; i < 3; i++) {
+                    indices.push_back(parseNumber<unsigned int>(line, lineNumber));
+                }
+            } else if (kind == "inst") {
+                SceneFormat::SceneInstance instance{};
+                instance.x = parseNumber<float>(line, lineNumber);
+                instance.y = parseNumber<float>(line, lineNumber);
+                instance.z = parseNumber<float>(line, lineNumber);
+                instance.r = parseNumber<int>(line, lineNumber) / 255.0f;
+                instance.g = parseNumber<int>(line, lineNumber) / 255.0f;
+                instance.b = parseNumber<int>(line, lineNumber) / 255.0f;
+                instances.push_back(instance);
+            } else {
+                throw std::runtime_error(std::format("line {}: unknown entry \"{}\"", lineNumber, kind));
+            }
+        }
+
+        size_t vertexCount = vertices.size() / 3;
+        for (auto index : indices) {
+            if (index >= vertexCount) {
+                throw std::runtime_error(std::format("index {} out of range, only {} vertices", index, vertexCount));
+            }
+        }
+
+        //before anything gets quantized, the reorder moves whole float vertices
+        MeshData mesh{std::move(vertices), std::move(indices)};
+        if (optimize) {
+            auto report = MeshOptimizer::optimize(mesh);
+            std::cout << std::format("optimized: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} ({}-entry FIFO), {} bit indices\n",
+                    report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr, MeshOptimizer::DEFAULT_CACHE_SIZE,
+                    report.narrowIndices ? 16 : 32);
+        }
+        vertices = std::move(mesh.vertices);
+        indices = std::move(mesh.indices);
+
+        //precomputed so loading never has to walk the vertices
+        DamageRect bounds{0, 0, 0, 0};
+        if (vertexCount > 0) {
+            bounds = {vertices[0], vertices[1], vertices[0], vertices[1]};
+            for (size_t i = 0; i < vertices.size(); i += 3) {
+                bounds.minX = std::min(bounds.minX, vertices[i]), bounds.maxX = std::max(bounds.maxX, vertices[i]);
+                bounds.minY = std::min(bounds.minY, vertices[i + 1]), bounds.maxY = std::max(bounds.maxY, vertices[i + 1]);
+            }
+        }
+
+        //kept alive until write(), the writer only references them
+        QuantizedMesh<HalfPositionVertex> halfVertices;
+        QuantizedMesh<Snorm16PositionVertex> snormVertices;
+        const QuantizationReport *report = nullptr;
+
+        SceneWriter writer;
+        if (positionFormat == "half") {
+            halfVertices = VertexQuantize::toHalfPositions(vertices);
+            writer.addSection<HalfPositionVertex>(SceneFormat::SectionType::HalfVertices, halfVertices.vertices);
+            report = &halfVertices.report;
+        } else if (positionFormat == "snorm16") {
+            snormVertices = VertexQuantize::toSnorm16Positions(vertices);
+            writer.addSection<Snorm16PositionVertex>(SceneFormat::SectionType::Snorm16Vertices, snormVertices.vertices);
+            report = &snormVertices.report;
+        } else {
+            writer.addSection<float>(SceneFormat::SectionType::Vertices, vertices);
+        }
+        writer.addSection<unsigned int>(SceneFormat::SectionType::Indices, indices);
+        writer.addSection(SceneFormat::SectionType::Bounds, sizeof(DamageRect), &bounds, 1);
+        if (!instances.empty()) {
+            writer.addSection<SceneFormat::SceneInstance>(SceneFormat::SectionType::Instances, instances);
+        }
+        writer.write(paths[1]);
+
+        std::cout << std::format("packed {} vertices, {} triangles, {} instances in {:.3f}ms\n",
+                vertexCount, indices.size() / 3, instances.size(),
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        if (report) {
+            std::cout << std::format("{} positions: {} -> {} bytes, error max {:.3g} mean {:.3g}, {} components clamped\n",
+                    positionFormat, report->bytesBefore, report->bytesAfter, report->maxPositionError, report->meanPositionError, report->clampedCount);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << std::format("ScenePacker: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * Draws a grid of squares once with a Square::draw() each and once marked static through a StaticBatch, then
+ * moves random squares in and out of the batch and recolors some to show what the incremental rebuilds upload.
+ *
+ * Usage: StaticBatchBench [grid size (default 100, so 10000 squares)] [churn rounds (default 20)]
+ *
+ * Renders into a hidden window, draw times include a glFinish.
+ * */
+#include "gl_deletion_queue.h"
+#include "gl_resources.h"
+#include "hidden_context.h"
+#include "shader_preprocessor.h"
+#include "square.h"
+#include "static_batch.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+extern "C" {
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <GL/gl.h>
+}
+
+namespace {
+    using HiddenContext::Clock;
+    using HiddenContext::msSince;
+
+    //square centered on the origin, size wide
+    MeshData makeCell(float size) {
+        float half = size / 2.0f;
+        return MeshData{
+            {half, half, 0.0f, half, -half, 0.0f, -half, -half, 0.0f, -half, half, 0.0f},
+            {0, 1, 3, 1, 2, 3}
+        };
+    }
+
+    void printStats(const char *label, const StaticBatch::Stats &stats) {
+        std::cout << std::format("{}: {} static squares, {} slots, {} reallocations, {} bytes uploaded\n", 
+                label, stats.entryCount, stats.slotCapacity, stats.reallocations, stats.uploadedBytes);
+    }
+}
+
+int main(int argc, char **argv) {
+    int gridSize = argc > 1 ? std::atoi(argv[1]) : 100;
+    int churnRounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    try {
+        HiddenContext::create(256, 256, "StaticBatchBench");
+        {
+            GLResources resources;
+            ShaderVariantCache shaders(resources);
+            ShaderHandle squareShader = shaders.get("shader.vert", "shader.frag");
+            ShaderHandle batchShader = shaders.get("shader.vert", "shader.frag", {{"STATIC_BATCH", "1"}});
+
+            float cellSize = 2.0f / gridSize;
+            MeshData cell = makeCell(cellSize);
+            VaoHandle vao = resources.getVaos().create(cell);
+            StaticBatch batch(resources, batchShader, cell);
+
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+            std::vector<std::unique_ptr<Square>> squares;
+            for (int y = 0; y < gridSize; y++) {
+                for (int x = 0; x < gridSize; x++) {
+                    GLPos pos{{-1.0f + (x + 0.5f) * cellSize, -1.0f + (y + 0.5f) * cellSize, 0.0f}};
+                    squares.push_back(std::make_unique<Square>(resources, vao, squareShader, std::array<float, 3>{channel(rng), channel(rng), channel(rng)}, pos));
+                }
+            }
+
+            glFinish();
+            auto start = Clock::now();
+            for (auto &square : squares) {
+                square->draw();
+            }
+            glFinish();
+            double squareDrawMs = msSince(start);
+
+            start = Clock::now();
+            for (auto &square : squares) {
+                square->setStatic(&batch);
+            }
+            double buildMs = msSince(start);
+
+            //first draw uploads everything
+            glFinish();
+            start = Clock::now();
+            batch.draw();
+            glFinish();
+            double firstBatchDrawMs = msSince(start);
+
+            start = Clock::now();
+            batch.draw();
+            glFinish();
+            double batchDrawMs = msSince(start);
+
+            std::cout << std::format("{} squares: {} draw calls vs 1\n", squares.size(), squares.size());
+            std::cout << std::format("draw: Square::draw {:.2f}ms, StaticBatch {:.2f}ms (first draw with upload {:.2f}ms, build {:.2f}ms)\n", 
+                    squareDrawMs, batchDrawMs, firstBatchDrawMs, buildMs);
+            printStats("built", batch.getStats());
+
+            //a few squares start moving (leave the batch), come back or get recolored each round
+            uint64_t uploadedBefore = batch.getStats().uploadedBytes;
+            start = Clock::now();
+            for (int round = 0; round < churnRounds; round++) {
+                for (int i = 0; i < gridSize; i++) {
+                    auto &square = squares[rng() % squares.size()];
+                    switch (rng() % 3) {
+                        case 0: square->setStatic(nullptr); break;
+                        case 1: square->setStatic(&batch); break;
+                        default: square->setColor({channel(rng), channel(rng), channel(rng)}); break;
+                    }
+                }
+                batch.draw();
+                for (auto &square : squares) {
+                    square->draw();
+                }
+            }
+            glFinish();
+            double churnMs = msSince(start);
+            printStats("churned", batch.getStats());
+            std::cout << std::format("churn: {:.2f}ms for {} rounds, {} bytes uploaded per round (full rebuild would be {})\n", churnMs, churnRounds,
+                    churnRounds > 0 ? (batch.getStats().uploadedBytes - uploadedBefore) / churnRounds : 0, 
+                    batch.size() * cell.vertices.size() / 3 * sizeof(ColorVertex));
+
+            squares.clear();
+            resources.destroyAll();
+        }
+        GLDeletionQueue::global().flush();
+        glfwTerminate();
+    } catch (const std::exception &e) {
+        std::cerr << std::format("StaticBatchBench: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}